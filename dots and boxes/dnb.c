@@ -0,0 +1,391 @@
+// the engine, compiled in here, is the library's own: only the functions of dnb.h are exported
+#define DNB_STATIC static __attribute__((unused))
+#include "dotsnboxes_variants.h"
+#include "dotsnboxes_db.h"
+#include "dnb.h"
+
+/* the library of dnb.h, over the same engine as solver */
+
+// boards kept at once: a batch that mixes a few sizes keeps a warm table for each
+#define DNB_BOARDS 4
+
+typedef struct DnbBoard{
+	board_t board;
+	search_t search; // set up with the board
+	bool used;
+	long int last_used; // for evicting the least recently used
+} dnb_board_t;
+
+/* dnb_solve_batch()'s shared state */
+typedef struct DnbBatch{
+	const dnb_position_t* positions;
+	const dnb_limits_t* limits;
+	dnb_result_t* results;
+	int* status;
+	int* order; // biggest first
+	int n;
+	int next; // in 'order', taken atomically
+} dnb_batch_t;
+
+struct DnbSolver{
+	dnb_board_t boards[DNB_BOARDS];
+	long int queries;
+	// dnb_solve_batch()'s pool: a context per thread, whose boards share this one's tables. the
+	// threads live from dnb_set_threads() to dnb_free(), waiting on 'wake' between batches
+	int threads;
+	dnb_solver_t** workers;
+	pthread_mutex_t lock;
+	pthread_cond_t wake; // a new batch, or time to quit
+	pthread_cond_t done; // the last thread finished the batch
+	dnb_batch_t* batch;
+	long int batches; // how many were handed out, for the threads to tell a new one
+	int busy; // threads still on the batch
+	int started; // threads running
+	bool quit;
+	// in a worker
+	dnb_solver_t* parent; // the context it works for
+	pthread_t thread;
+	bool running;
+	book_t books[DNB_BOARDS]; // dnb_add_book(), for the workers too
+	int n_books;
+};
+
+/* the context's opening book for boards of this size, or null */
+static const book_t* dnb_book(dnb_solver_t* solver, int rows, int cols){
+	dnb_solver_t* owner = solver->parent != NULL ? solver->parent : solver;
+	return book_find(owner->books, owner->n_books, rows, cols);
+}
+
+/* in a worker, use the parent's table for the slot's board size, if it has one */
+static void dnb_attach(dnb_solver_t* solver, dnb_board_t* slot){
+	if(solver->parent == NULL) return;
+	for(int b=0; b<DNB_BOARDS; ++b){
+		dnb_board_t* p = &solver->parent->boards[b];
+		if(p->used && p->board.rows == slot->board.rows && p->board.cols == slot->board.cols && p->board.memo_hashtable != NULL)
+			share_memo(&slot->board, &p->board);
+	}
+}
+
+dnb_solver_t* dnb_create(void){
+	dnb_solver_t* solver = (dnb_solver_t*) calloc(1, sizeof(dnb_solver_t));
+	pthread_mutex_init(&solver->lock, NULL);
+	pthread_cond_init(&solver->wake, NULL);
+	pthread_cond_init(&solver->done, NULL);
+	return solver;
+}
+
+/* the worker's share of a batch: the parent's tables, as many positions as it gets to first, and
+	letting go of the tables again, which the parent may free before the next batch */
+static void dnb_run(dnb_solver_t* worker, dnb_batch_t* b){
+	for(int k=0; k<DNB_BOARDS; ++k)
+		if(worker->boards[k].used) dnb_attach(worker, &worker->boards[k]);
+	for(int k; (k = __atomic_fetch_add(&b->next, 1, __ATOMIC_RELAXED)) < b->n; ){
+		int i = b->order[k];
+		b->status[i] = dnb_solve(worker, &b->positions[i], b->limits, &b->results[i]);
+	}
+	for(int k=0; k<DNB_BOARDS; ++k){
+		board_t* board = &worker->boards[k].board;
+		if(worker->boards[k].used && board->memo_shared) free_memo(board);
+	}
+}
+
+/* a pool thread: one dnb_run() for every batch, until dnb_pool_stop() */
+static void* dnb_work(void* arg){
+	dnb_solver_t* worker = (dnb_solver_t*) arg;
+	dnb_solver_t* solver = worker->parent;
+	long int seen = 0;
+	pthread_mutex_lock(&solver->lock);
+	for(;;){
+		while(!solver->quit && solver->batches == seen) pthread_cond_wait(&solver->wake, &solver->lock);
+		if(solver->quit) break;
+		seen = solver->batches;
+		dnb_batch_t* batch = solver->batch;
+		pthread_mutex_unlock(&solver->lock);
+		dnb_run(worker, batch);
+		pthread_mutex_lock(&solver->lock);
+		if(--solver->busy == 0) pthread_cond_signal(&solver->done);
+	}
+	pthread_mutex_unlock(&solver->lock);
+	return NULL;
+}
+
+static void dnb_pool_start(dnb_solver_t* solver){
+	solver->quit = false;
+	solver->started = 0;
+	if(solver->threads <= 1) return;
+	for(int w=0; w<solver->threads; ++w){
+		dnb_solver_t* worker = solver->workers[w];
+		worker->running = pthread_create(&worker->thread, NULL, dnb_work, worker) == 0;
+		solver->started += worker->running;
+	}
+}
+
+static void dnb_pool_stop(dnb_solver_t* solver){
+	pthread_mutex_lock(&solver->lock);
+	solver->quit = true;
+	pthread_cond_broadcast(&solver->wake);
+	pthread_mutex_unlock(&solver->lock);
+	for(int w=0; w<solver->threads; ++w){
+		if(solver->workers[w]->running) pthread_join(solver->workers[w]->thread, NULL);
+		solver->workers[w]->running = false;
+	}
+	solver->started = 0;
+}
+
+static void dnb_drop_board(dnb_board_t* slot){
+	if(!slot->used) return;
+	PERF(perf_close(&slot->search.perf);)
+	cleanup(&slot->board);
+	slot->used = false;
+}
+
+void dnb_free(dnb_solver_t* solver){
+	if(solver == NULL) return;
+	dnb_pool_stop(solver);
+	for(int w=0; w<solver->threads; ++w) dnb_free(solver->workers[w]);
+	free(solver->workers);
+	for(int b=0; b<DNB_BOARDS; ++b) dnb_drop_board(&solver->boards[b]);
+	for(int b=0; b<solver->n_books; ++b) book_close(&solver->books[b]);
+	pthread_mutex_destroy(&solver->lock);
+	pthread_cond_destroy(&solver->wake);
+	pthread_cond_destroy(&solver->done);
+	free(solver);
+}
+
+void dnb_reset(dnb_solver_t* solver){
+	for(int w=0; w<solver->threads; ++w) dnb_reset(solver->workers[w]);
+	for(int b=0; b<DNB_BOARDS; ++b)
+		if(solver->boards[b].used) free_memo(&solver->boards[b].board);
+}
+
+void dnb_set_threads(dnb_solver_t* solver, int threads){
+	if(threads < 1) threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if(threads < 1) threads = 1;
+	dnb_pool_stop(solver);
+	for(int w=threads; w<solver->threads; ++w) dnb_free(solver->workers[w]);
+	solver->workers = (dnb_solver_t**) realloc(solver->workers, sizeof(dnb_solver_t*) * threads);
+	for(int w=solver->threads; w<threads; ++w){
+		solver->workers[w] = dnb_create();
+		solver->workers[w]->parent = solver;
+	}
+	solver->threads = threads;
+	dnb_pool_start(solver);
+}
+
+/* the board of this size, made (in place of the least recently used) if there is none yet */
+static dnb_board_t* dnb_board(dnb_solver_t* solver, int rows, int cols){
+	dnb_board_t* slot = NULL;
+	for(int b=0; b<DNB_BOARDS && slot == NULL; ++b){
+		dnb_board_t* s = &solver->boards[b];
+		if(s->used && s->board.rows == rows && s->board.cols == cols) slot = s;
+	}
+	if(slot == NULL){
+		slot = &solver->boards[0];
+		for(int b=1; b<DNB_BOARDS && slot->used; ++b)
+			if(!solver->boards[b].used || solver->boards[b].last_used < slot->last_used) slot = &solver->boards[b];
+		dnb_drop_board(slot);
+		init_board(&slot->board, rows, cols);
+		slot->board.book = dnb_book(solver, rows, cols);
+		search_init(&slot->search, &slot->board);
+		// in debug builds, a trace of its own for every board, worker threads' included
+		TRACE(slot->search.trace = trace_from_env(&slot->board);)
+		slot->used = true;
+		dnb_attach(solver, slot);
+	}
+	slot->last_used = ++solver->queries;
+	return slot;
+}
+
+int dnb_add_book(dnb_solver_t* solver, const char* path){
+	if(solver->n_books == DNB_BOARDS || book_open(&solver->books[solver->n_books], path) != NULL) return DNB_INVALID;
+	book_t* book = &solver->books[solver->n_books++];
+	// boards made before it, here and in the workers
+	for(int w=-1; w<solver->threads; ++w){
+		dnb_solver_t* s = w < 0 ? solver : solver->workers[w];
+		for(int b=0; b<DNB_BOARDS; ++b)
+			if(s->boards[b].used && s->boards[b].board.rows == book->rows && s->boards[b].board.cols == book->cols)
+				s->boards[b].board.book = book;
+	}
+	return DNB_OK;
+}
+
+int dnb_wall_index(int rows, int cols, int row, int col, int wall){
+	if(row < 0 || row >= rows || col < 0 || col >= cols) return -1;
+	if(wall != DNB_TOP && wall != DNB_BOTTOM && wall != DNB_LEFT && wall != DNB_RIGHT) return -1;
+	// wall_index() only needs the size
+	board_t size;
+	size.rows = rows;
+	size.cols = cols;
+	return wall_index(row, col, wall, &size);
+}
+
+const char* dnb_error(int code){
+	switch(code){
+	case DNB_OK: return "ok";
+	case DNB_LIMIT: return "stopped by a limit";
+	case DNB_INVALID: return "invalid position";
+	case DNB_TOO_BIG: return "too many walls for an exact solve";
+	case DNB_UNKNOWN_VARIANT: return "unknown variant";
+	}
+	return "unknown error";
+}
+
+int dnb_parse_position(const char* text, dnb_position_t* position){
+	position_t p;
+	if(!parse_position(text, &p)) return DNB_INVALID;
+	position->rows = p.rows;
+	position->cols = p.cols;
+	position->walls = p.walls;
+	position->scores[0] = p.scores[0];
+	position->scores[1] = p.scores[1];
+	position->player = p.player;
+	return DNB_OK;
+}
+
+int dnb_format_position(const dnb_position_t* position, char* text, int size){
+	position_t p = {position->rows, position->cols, position->walls, {position->scores[0], position->scores[1]},
+		position->player};
+	return format_position(&p, text, size);
+}
+
+/* the context's board for 'position', in that position, and the variant to solve it with.
+	returns DNB_OK or why not */
+static int dnb_setup(dnb_solver_t* solver, const dnb_position_t* position, const dnb_limits_t* limits,
+	dnb_board_t** slot, variant_t** variant){
+	const dnb_position_t* p = position;
+	if(p->rows < 1 || p->cols < 1 || p->player < 0 || p->player > 1 || p->scores[0] < 0 || p->scores[1] < 0)
+		return DNB_INVALID;
+	if(p->rows > MAX_UID_WALLS || p->cols > MAX_UID_WALLS) return DNB_TOO_BIG;
+	int walls = 2*p->rows*p->cols + p->rows + p->cols;
+	if(walls > MAX_UID_WALLS) return DNB_TOO_BIG;
+	if(walls < MAX_UID_WALLS && (p->walls >> walls) != 0) return DNB_INVALID;
+	*variant = find_variant(limits != NULL && limits->variant != NULL ? limits->variant : "ab_sym_memo_order",
+		p->rows, p->cols, false);
+	if(*variant == NULL) return DNB_UNKNOWN_VARIANT;
+
+	*slot = dnb_board(solver, p->rows, p->cols);
+	board_t* board = &(*slot)->board;
+	set_position(board, p->walls, p->scores[0], p->scores[1], p->player);
+	// every box taken was taken by somebody
+	if(boxes_closed(board) != p->scores[0] + p->scores[1]) return DNB_INVALID;
+
+	search_t* search = &(*slot)->search;
+	search->turn_count = 0;
+	search->memo_probes = 0;
+	search->memo_hits = 0;
+	search->memo_stored = 0;
+	search_limit(search, limits != NULL ? limits->max_turns : 0, limits != NULL ? limits->max_ms : 0);
+	return DNB_OK;
+}
+
+static void dnb_move(turn_t* turn, dnb_move_t* move){
+	move->row = turn != NULL ? turn->row : -1;
+	move->col = turn != NULL ? turn->col : -1;
+	move->wall = turn != NULL ? turn->wall : 0;
+	move->index = turn != NULL ? turn->index : -1;
+}
+
+int dnb_solve(dnb_solver_t* solver, const dnb_position_t* position, const dnb_limits_t* limits, dnb_result_t* result){
+	double start = now_ms();
+	dnb_board_t* slot;
+	variant_t* variant;
+	int status = dnb_setup(solver, position, limits, &slot, &variant);
+	if(status != DNB_OK) return status;
+	board_t* board = &slot->board;
+	search_t* search = &slot->search;
+	int value = 0;
+	turn_t* best = variant->solve(search, predict_margin(board), &value);
+	result->value = search->aborted ? 0 : value;
+	// solve() has no turn for a finished game
+	dnb_move(game_is_over(board) ? NULL : best, &result->best);
+	result->turns = search->turn_count;
+	result->ms = now_ms() - start;
+	return search->aborted ? DNB_LIMIT : DNB_OK;
+}
+
+int dnb_best_move(dnb_solver_t* solver, const dnb_position_t* position, const dnb_limits_t* limits, dnb_move_t* move){
+	dnb_result_t result;
+	int status = dnb_solve(solver, position, limits, &result);
+	if(status == DNB_OK) *move = result.best;
+	return status;
+}
+
+int dnb_analyze_all_moves(dnb_solver_t* solver, const dnb_position_t* position, const dnb_limits_t* limits,
+	dnb_result_t* results, int max, int* n){
+	dnb_board_t* slot;
+	variant_t* variant;
+	*n = 0;
+	int status = dnb_setup(solver, position, limits, &slot, &variant);
+	if(status != DNB_OK) return status;
+	move_value_t moves[MAX_UID_WALLS];
+	int found = analyze_moves(&slot->search, variant, predict_margin(&slot->board), moves);
+	if(found < 0) return DNB_LIMIT;
+	for(int k=0; k<found && k<max; ++k){
+		results[k].value = moves[k].value;
+		dnb_move(moves[k].turn, &results[k].best);
+		results[k].turns = moves[k].turns;
+		results[k].ms = moves[k].ms;
+	}
+	*n = found;
+	return DNB_OK;
+}
+
+/* a position to schedule, with the walls left to draw as a cheap stand-in for how long it takes:
+	every one of them multiplies the tree */
+typedef struct DnbJob{
+	int left;
+	int index;
+} dnb_job_t;
+
+/* biggest first; ties in input order, so the schedule does not depend on qsort() */
+static int dnb_by_size(const void* a, const void* b){
+	const dnb_job_t* p = (const dnb_job_t*) a;
+	const dnb_job_t* q = (const dnb_job_t*) b;
+	return p->left != q->left ? q->left - p->left : p->index - q->index;
+}
+
+void dnb_solve_batch(dnb_solver_t* solver, const dnb_position_t* positions, int n, const dnb_limits_t* limits,
+	dnb_result_t* results, int* status){
+	if(solver->threads <= 1){
+		for(int i=0; i<n; ++i) status[i] = dnb_solve(solver, &positions[i], limits, &results[i]);
+		return;
+	}
+	dnb_job_t* jobs = (dnb_job_t*) malloc(sizeof(dnb_job_t) * n);
+	for(int i=0; i<n; ++i){
+		const dnb_position_t* p = &positions[i];
+		jobs[i].left = 2*p->rows*p->cols + p->rows + p->cols - __builtin_popcountll(p->walls);
+		jobs[i].index = i;
+	}
+	qsort(jobs, n, sizeof(dnb_job_t), dnb_by_size);
+	dnb_batch_t batch = {positions, limits, results, status, (int*) malloc(sizeof(int) * n), n, 0};
+	for(int k=0; k<n; ++k) batch.order[k] = jobs[k].index;
+	free(jobs);
+
+	// the tables to share, one per size (for as many sizes as there are boards, biggest first)
+	int sizes = 0;
+	for(int k=0; k<n && sizes < DNB_BOARDS; ++k){
+		const dnb_position_t* p = &positions[batch.order[k]];
+		if(p->rows < 1 || p->cols < 1 || 2*p->rows*p->cols + p->rows + p->cols > MAX_UID_WALLS) continue;
+		bool seen = false;
+		for(int j=0; j<k && !seen; ++j)
+			seen = positions[batch.order[j]].rows == p->rows && positions[batch.order[j]].cols == p->cols;
+		if(seen) continue;
+		dnb_board_t* slot = dnb_board(solver, p->rows, p->cols);
+		if(slot->board.memo_hashtable == NULL) init_memo(&slot->board);
+		++sizes;
+	}
+
+	// hand the batch to the pool, or, without threads to spare, do it here
+	if(solver->started == 0) dnb_run(solver->workers[0], &batch);
+	else{
+		pthread_mutex_lock(&solver->lock);
+		solver->batch = &batch;
+		solver->busy = solver->started;
+		solver->batches++;
+		pthread_cond_broadcast(&solver->wake);
+		while(solver->busy > 0) pthread_cond_wait(&solver->done, &solver->lock);
+		solver->batch = NULL;
+		pthread_mutex_unlock(&solver->lock);
+	}
+	free(batch.order);
+}
@@ -0,0 +1,120 @@
+#ifndef DNB_H
+#define DNB_H
+
+#include <stdint.h>
+
+/* The exact solver as a library (libdnb.a, from dnb.c), for programs that ask it about many
+	positions: a context keeps its boards, their turns and their tables from one query to the next
+	(one for each of the last few board sizes it was asked about), so that a position costs no
+	set-up, and everything already solved on the way to earlier answers is still in the table.
+	The library exports only the functions below; the engine inside it is all static, so its
+	names cannot clash with a program's. Nothing is shared between contexts (the one exception is
+	the list of search traces that debug builds keep, see dotsnboxes_trace.h), so contexts are
+	independent of each other, but one context must not be used by two threads at once (for
+	parallel solves, give it threads of its own with dnb_set_threads() and use dnb_solve_batch()).
+
+		dnb_solver_t* s = dnb_create();
+		dnb_position_t p = {3, 3, 0, {0, 0}, 0}; // empty 3x3, first player to move
+		dnb_result_t r;
+		if(dnb_solve(s, &p, NULL, &r) == DNB_OK) printf("%d\n", r.value);
+		dnb_free(s);
+
+	Positions only need the walls, scores and player to move, not how they came about: walls are
+	bits by dnb_wall_index(), the numbering of wall_index() in dotsnboxes.h. Values are final
+	margins (the player to move's boxes minus the other's, at the end of the game, counting the
+	boxes already taken) with best play from both sides.
+
+	As text (dnb_parse_position()), a position is "rows cols walls score0 score1 player", with the
+	walls in hex, e.g. "2 3 1a1 0 0 0"; "rows cols" alone is the start of a game. */
+
+// sides of a box, as in dotsnboxes.h
+#define DNB_TOP 0x1
+#define DNB_BOTTOM 0x2
+#define DNB_LEFT 0x4
+#define DNB_RIGHT 0x8
+
+// what the calls return
+#define DNB_OK 0
+#define DNB_LIMIT 1             // stopped by dnb_limits_t before it had an answer
+#define DNB_INVALID -1          // not a position: walls off the board, scores that do not add up...
+#define DNB_TOO_BIG -2          // more walls than an exact solve can handle (64)
+#define DNB_UNKNOWN_VARIANT -3
+
+typedef struct DnbSolver dnb_solver_t;
+
+typedef struct DnbPosition{
+	int rows, cols;
+	uint64_t walls; // bit dnb_wall_index() set for every wall drawn
+	int scores[2]; // boxes taken by each player
+	int player; // 0 or 1, to move
+} dnb_position_t;
+
+/* null for the defaults: the fastest variant and no limits */
+typedef struct DnbLimits{
+	const char* variant; // as listed by "solver list", null for "ab_sym_memo_order"
+	long int max_turns; // 0 for no limit
+	double max_ms; // 0 for no limit
+} dnb_limits_t;
+
+typedef struct DnbMove{
+	int row, col;
+	int wall; // DNB_TOP...
+	int index; // dnb_wall_index(), -1 for none (the game is over)
+} dnb_move_t;
+
+typedef struct DnbResult{
+	int value; // final margin for the player to move
+	dnb_move_t best; // a turn that gets it
+	long int turns; // turns searched
+	double ms;
+} dnb_result_t;
+
+dnb_solver_t* dnb_create(void);
+void dnb_free(dnb_solver_t* solver);
+
+/* threads for dnb_solve_batch(), 0 for one per core. 1 (the default) solves in the caller's. they
+	are started here and wait between batches until the next call or dnb_free() */
+void dnb_set_threads(dnb_solver_t* solver, int threads);
+
+/* look positions of the book's board size up in the opening book (made by solver_book) in 'path'
+	before searching them, for up to four board sizes. DNB_OK, or DNB_INVALID if it cannot be read */
+int dnb_add_book(dnb_solver_t* solver, const char* path);
+
+/* forget everything solved so far (the table), e.g. to bound memory */
+void dnb_reset(dnb_solver_t* solver);
+
+/* value and best turn of 'position' into 'result' */
+int dnb_solve(dnb_solver_t* solver, const dnb_position_t* position, const dnb_limits_t* limits, dnb_result_t* result);
+
+/* just the best turn */
+int dnb_best_move(dnb_solver_t* solver, const dnb_position_t* position, const dnb_limits_t* limits, dnb_move_t* move);
+
+/* every legal turn, each with the value (for the player to move in 'position') of playing it, best
+	first, in 'results' (room for up to 'max'), and how many there are in 'n'. costs little more
+	than dnb_solve() (see analyze_moves() in dotsnboxes_variants.h). the limits are for all of them
+	together */
+int dnb_analyze_all_moves(dnb_solver_t* solver, const dnb_position_t* position, const dnb_limits_t* limits,
+	dnb_result_t* results, int max, int* n);
+
+/* dnb_solve() for each of 'n' independent positions, into results[i] and status[i] in the order
+	given, spread across the threads of dnb_set_threads(); the limits are per position. positions
+	that look biggest go first, so that the last ones to finish are small. the threads share the
+	context's table for each board size (up to four sizes), so what one solves the others can use:
+	the values do not depend on the timing, but the best turns and turn counts can */
+void dnb_solve_batch(dnb_solver_t* solver, const dnb_position_t* positions, int n, const dnb_limits_t* limits,
+	dnb_result_t* results, int* status);
+
+/* bit of the wall on side 'wall' of box (row, col) in dnb_position_t.walls, -1 if there is none */
+int dnb_wall_index(int rows, int cols, int row, int col, int wall);
+
+/* a position from its text form, see above. DNB_OK, or DNB_INVALID if it does not parse (which
+	says nothing about whether it is a valid position) */
+int dnb_parse_position(const char* text, dnb_position_t* position);
+
+/* the text form of 'position' into 'text' (room for 'size' bytes), like snprintf() */
+int dnb_format_position(const dnb_position_t* position, char* text, int size);
+
+/* what a return code means */
+const char* dnb_error(int code);
+
+#endif
@@ -1,17 +1,76 @@
+// clock_gettime() and friends
+#define _POSIX_C_SOURCE 200809L
+// syscall(), for perf_event_open() in dotsnboxes_perf.h, and anonymous mmap() and madvise(), for
+// the table (huge_alloc())
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <limits.h>
 #include <assert.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/mman.h>
+
+// storage class of every function and table of the engine's headers: nothing here, so that the
+// programs that include them can share them. dnb.c, which compiles them into libdnb.a, makes
+// them static, so that the library exports nothing but dnb.h
+#ifndef DNB_STATIC
+#define DNB_STATIC
+#endif
+
+// search counters (dotsnboxes_counters.h) only exist when built with -DCOUNTERS ("make
+// counters"): otherwise COUNT(...) drops its argument
+#ifdef COUNTERS
+#define COUNT(...) __VA_ARGS__
+#else
+#define COUNT(...)
+#endif
 
 #define TOP 0x1
 #define BOTTOM 0x2
 #define LEFT 0x4
 #define RIGHT 0x8
+#define TOP_OR_BOTTOM   (TOP   | BOTTOM)
+#define LEFT_OR_RIGHT   (LEFT  | RIGHT)
+#define LEFT_OR_TOP     (LEFT  | TOP)
+#define RIGHT_OR_BOTTOM (RIGHT | BOTTOM)
+#define RIGHT_OR_TOP    (RIGHT | TOP)
+#define LEFT_OR_BOTTOM  (LEFT  | BOTTOM)
+
+// types of symmetries (also indexes into the per-turn pair arrays)
+// note that index 0 is the identity and is never used
+
+// first 3 are valid for any shape
+#define HORIZONTAL 1
+#define VERTICAL   2
+#define ROT_180    3
+// these 4 are only valid on square boards
+#define ROT_90     4
+#define ROT_270    5
+#define DIAG_TL_BR 6
+#define DIAG_TR_BL 7
+#define MAX_SYMMETRIES 8
+
+// Memoization hashtable will have 2^bitwidth entries
+#define HASHTABLE_BITWIDTH 24
+// lengths of bucket chain walks told apart by the counters; the last counts all longer ones
+#define MEMO_CHAINS 8
+
+// what a memoized value means. alpha-beta only learns a bound when it cuts the search short.
+// bounds are on the swing, i.e. from the point of view of the player to move
+#define BOUND_EXACT 0
+#define BOUND_LOWER 1 // the true swing is at least the stored value
+#define BOUND_UPPER 2 // the true swing is at most the stored value
+
+// every wall gets its own bit of the board i.d., so exact search is limited to this many walls
+// (5x5 has 60). larger boards still work for everything that does not need an i.d. (mcts, pns)
+#define MAX_UID_WALLS 64
 
 typedef short square_t;
 typedef short wall_t;
+typedef uint64_t bid_t; // bid = "board i.d."
 typedef struct Turn turn_t;
 struct Turn{
 	int row, col;
@@ -19,25 +78,206 @@ struct Turn{
 	// linked list of turns (which are valid)
 	turn_t* prev;
 	turn_t* next;
+	// the turn that each symmetry maps this one onto, and the one it maps onto this (null if the
+	// turn maps onto itself)
+	turn_t* pairs[MAX_SYMMETRIES];
+	turn_t* inverse_pairs[MAX_SYMMETRIES];
+	int index; // wall_index()
+	bid_t uid; // bit 'index' (zero past MAX_UID_WALLS)
 };
+/* objects that all go at once, e.g. the entries of a table: each one a pointer bump into chunks
+	of ARENA_CHUNK bytes (or of one huge page, see huge_alloc()), and arena_release() frees them
+	all, a chunk at a time. several threads can fill one arena, each with a slab_t of its own */
+#define ARENA_CHUNK (1 << 20)
+#define ARENA_ALIGN 16
+typedef struct ArenaChunk{
+	struct ArenaChunk* next;
+	size_t bytes;
+} arena_chunk_t; // followed by the objects, from ARENA_ALIGN bytes in
+typedef struct Arena{
+	arena_chunk_t* chunks; // newest first
+	bool huge; // chunks from huge_alloc(), else malloc()
+} arena_t;
+typedef struct Slab{
+	char* next; // free space in the chunk one thread is filling
+	char* end;
+} slab_t;
+
+/* an entry of the board's table, in 16 bytes: the link and one packed word. the bucket already
+	says what the low memo_bits of the uid are, so the entry only keeps the rest, up to
+	MEMO_KEY_BITS of them (memo_key(); init_memo() makes the table big enough for that) */
+#define MEMO_KEY_BITS 40
+typedef struct Memo memo_t;
+struct Memo{
+	memo_t* next;
+	uint32_t key; // memo_key(), low bits
+	unsigned int key_high : 8; // and the rest
+	signed int value : 8; // swing
+	unsigned int bound : 2;
+	unsigned int best_move : 6; // wall_index(), so that boards sharing a table (share_memo()) can all use it
+	unsigned int generation : 8; // the board's memo_generation, modulo 256, when last written or found (age_memo())
+};
+/* an entry of a read-only table of solved positions (dotsnboxes_db.h), for looking up under the
+	board's own: the same as a memo entry, with the whole uid and no link, in an open-addressing
+	table */
+typedef struct Solved{
+	bid_t uid; // SOLVED_EMPTY in a free slot
+	int16_t value;
+	uint8_t bound;
+	uint8_t best_move;
+	uint32_t unused;
+} solved_t;
+#define SOLVED_EMPTY UINT64_MAX
+
+typedef struct SolvedDb{
+	const solved_t* slots;
+	int bits; // 2^bits slots
+	long int entries;
+	int rows, cols;
+	int max_walls; // none of its positions has more walls drawn, so deeper ones are not looked up
+	void* map; // the file, mmap()ed
+	size_t map_size;
+} solved_db_t;
+
+/* an opening book (dotsnboxes_db.h): the exact value and a best turn of every position up to a
+	few walls deep, one entry for all of a position's symmetric images (canonical_uid()), sorted */
+typedef struct BookMove{
+	int8_t value; // swing, as in memo_t
+	uint8_t best_move; // wall_index(), in the canonical position
+} book_move_t;
+
+typedef struct Book{
+	const bid_t* uids; // canonical, ascending
+	const book_move_t* moves; // for each of them
+	long int entries;
+	int rows, cols;
+	int plies; // walls drawn in the deepest positions, after as many turns
+	void* map; // the file, mmap()ed
+	size_t map_size;
+} book_t;
+
 typedef struct Board{
+	void* block; // squares, turns and the sentinel, in one allocation
 	square_t* squares;
 	turn_t* sentinel; // pointer to the sentinel of the doubly linked list of turns
+	turn_t** turns; // every turn by wall_index(), whether played or not
+	int n_lists; // 1 + number of symmetries the board shape allows
 	int rows;
 	int cols;
 	int player_turn;
 	int scores[2];
+	bid_t uid; // one bit per drawn wall
+	// per symmetry: how many drawn walls have an undrawn mirror image. zero means the position has
+	// that symmetry. only kept up to date by play_symmetries()/unplay_symmetries()
+	int asymmetry[MAX_SYMMETRIES];
+	memo_t** memo_hashtable; // null until init_memo()
+	arena_t* memo_arena; // the entries of the table, freed with it
+	slab_t memo_slab; // this board's part of it
+	memo_t* memo_free; // entries dropped by age_memo(), to be used again
+	long int memo_count; // entries this board put in the table, less those age_memo() dropped
+	int memo_bits; // 2^memo_bits buckets: HASHTABLE_BITWIDTH, unless changed before init_memo()
+	bool memo_shared; // the table is share_memo()'s, and other threads write to it too
+	int memo_generation; // stamped on table entries as they are used, 0 unless the caller counts
+	const solved_db_t* solved; // null, or looked up where the table has nothing (probe_memo())
+	const book_t* book; // null, or looked up likewise, for positions no deeper than its plies
+	memo_t solved_hit; // the last entry found in either, as a memo entry
+	// every walk of a bucket by probe_table(), counted along the way (dotsnboxes_counters.h)
+	COUNT(long int memo_chains[MEMO_CHAINS];) // walks by how many entries they looked at
+	COUNT(long int memo_walked;) // entries looked at
+	COUNT(long int memo_collisions;) // of those, other positions stepped over
+	COUNT(long int memo_chain_max;) // longest walk
 } board_t;
 
+/* a position as text: "rows cols walls score0 score1 player", the walls a hex bitmask by
+	wall_index() (parse_position(), format_position()) */
+typedef struct Position{
+	int rows, cols;
+	bid_t walls;
+	int scores[2];
+	int player;
+} position_t;
+
+// half-width of the first aspiration window at the root (doubles on every re-search)
+#define ASPIRATION_WINDOW 1
+
 // usually bad practice, but ok for small code
 #define max(a,b) (a) > (b) ? (a) : (b)
 #define min(a,b) (a) < (b) ? (a) : (b)
 
-turn_t* make_turn_dll(int r, int c, wall_t wall){
-	turn_t* new_turn = (turn_t*) malloc(sizeof(turn_t));
+/* 'bytes' of zeroed memory for a big table, for huge_free(): in huge pages where the system has
+	them, since probes land all over it and with 4 kB pages nearly every one misses the tlb. a
+	reserved huge page pool (MAP_HUGETLB) first, otherwise ordinary pages aligned so that
+	transparent huge pages can back them. null if there is no memory. only worth it for a table
+	that gets filled: the first touch anywhere in a huge page zeroes all 2 MB of it (memo_is_huge()) */
+#define HUGE_PAGE ((size_t) 1 << 21)
+DNB_STATIC void* huge_alloc(size_t bytes){
+	if(bytes < HUGE_PAGE) return calloc(1, bytes);
+	bytes = (bytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+	char* p;
+#ifdef MAP_HUGETLB
+	p = (char*) mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if(p != MAP_FAILED) return p;
+#endif
+	// a huge page more than needed, less what is in front of the first boundary and after the last
+	p = (char*) mmap(NULL, bytes + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(p == MAP_FAILED) return NULL;
+	size_t skip = (HUGE_PAGE - (uintptr_t) p % HUGE_PAGE) % HUGE_PAGE;
+	if(skip > 0) munmap(p, skip);
+	munmap(p + skip + bytes, HUGE_PAGE - skip);
+	p += skip;
+#ifdef MADV_HUGEPAGE
+	madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+	return p;
+}
+
+DNB_STATIC void huge_free(void* p, size_t bytes){
+	if(p == NULL) return;
+	if(bytes < HUGE_PAGE) free(p);
+	else munmap(p, (bytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1));
+}
+
+/* room for 'size' bytes in 'arena', from the thread's 'slab'. null if there is no memory */
+DNB_STATIC void* arena_alloc(arena_t* arena, slab_t* slab, size_t size){
+	size = (size + ARENA_ALIGN - 1) & ~(size_t) (ARENA_ALIGN - 1);
+	if(slab->next == NULL || (size_t) (slab->end - slab->next) < size){
+		size_t chunk_bytes = arena->huge ? HUGE_PAGE : ARENA_CHUNK;
+		size_t bytes = size > chunk_bytes - ARENA_ALIGN ? size + ARENA_ALIGN : chunk_bytes;
+		arena_chunk_t* chunk = (arena_chunk_t*) (arena->huge ? huge_alloc(bytes) : malloc(bytes));
+		if(chunk == NULL) return NULL;
+		chunk->bytes = bytes;
+		// other threads may be adding chunks too
+		chunk->next = __atomic_load_n(&arena->chunks, __ATOMIC_RELAXED);
+		while(!__atomic_compare_exchange_n(&arena->chunks, &chunk->next, chunk, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+		slab->next = (char*) chunk + ARENA_ALIGN;
+		slab->end = (char*) chunk + bytes;
+	}
+	void* object = slab->next;
+	slab->next += size;
+	return object;
+}
+
+/* free everything in the arena, once no thread uses it any more */
+DNB_STATIC void arena_release(arena_t* arena){
+	for(arena_chunk_t* chunk = arena->chunks; chunk != NULL; ){
+		arena_chunk_t* next = chunk->next;
+		if(arena->huge) huge_free(chunk, chunk->bytes);
+		else free(chunk);
+		chunk = next;
+	}
+	arena->chunks = NULL;
+}
+
+/* set up 'new_turn' (in the board's block) as a turn on its own */
+DNB_STATIC turn_t* make_turn_dll(turn_t* new_turn, int r, int c, wall_t wall, bid_t id){
 	new_turn->wall = wall; // sentinel value
 	new_turn->row = r;
 	new_turn->col = c;
+	new_turn->uid = id;
+	for(int s=0; s<MAX_SYMMETRIES; ++s){
+		new_turn->pairs[s] = NULL;
+		new_turn->inverse_pairs[s] = NULL;
+	}
 	// link to itself
 	new_turn->prev = new_turn;
 	new_turn->next = new_turn;
@@ -45,7 +285,7 @@ turn_t* make_turn_dll(int r, int c, wall_t wall){
 }
 
 /* insert the 'new' dll node between 'after' and 'after->next' */
-void add_turn_dll(turn_t* after, turn_t* new){
+DNB_STATIC void add_turn_dll(turn_t* after, turn_t* new){
 	new->next = after->next;
 	after->next->prev = new;
 	after->next = new;
@@ -57,7 +297,7 @@ void add_turn_dll(turn_t* after, turn_t* new){
 	add_turn_dll(remove_turn_dll(turn), turn);
 
 has net-zero-effect */
-turn_t* remove_turn_dll(turn_t* turn){
+DNB_STATIC turn_t* remove_turn_dll(turn_t* turn){
 	turn_t* set_to = turn->prev;
 	// bypass
 	turn->prev->next = turn->next;
@@ -68,57 +308,251 @@ turn_t* remove_turn_dll(turn_t* turn){
 	return set_to;
 }
 
-void stdin_to_board(board_t* empty_board){
-	// assuming well-formed inputs
-	int rows = 0, cols = 0;
-	char c = fgetc(stdin);
-	while('0' <= c && c <= '9'){
-		rows *= 10;
-		rows += c-'0';
-		c = fgetc(stdin);
+DNB_STATIC bool turn_equals(turn_t* a, turn_t* b){
+	if(a->row == b->row && a->col == b->col && a->wall == b->wall) return true;
+	if(abs(a->row - b->row) + abs(a->col - b->col) > 1) return false;
+	// they're not a perfect match, but they're one apart. now we need to check wall directions
+	if(a->row < b->row && a->wall == BOTTOM && b->wall == TOP) return true;
+	if(a->row > b->row && a->wall == TOP && b->wall == BOTTOM) return true;
+	if(a->col < b->col && a->wall == RIGHT && b->wall == LEFT) return true;
+	if(a->col > b->col && a->wall == LEFT && b->wall == RIGHT) return true;
+	return false;
+}
+
+// Symmetries function (writes symmetry into dest)
+DNB_STATIC void sym_horizontal(turn_t* turn, turn_t* dest, board_t* board){
+	dest->row = turn->row;
+	dest->col = board->cols - turn->col - 1;
+	// if mirroring one of top/bottom, copy same.
+	// if mirroring one of left/right, flip it
+	dest->wall = turn->wall & TOP_OR_BOTTOM ? turn->wall : turn->wall ^ LEFT_OR_RIGHT;
+}
+DNB_STATIC void sym_vertical(turn_t* turn, turn_t* dest, board_t* board){
+	dest->col = turn->col;
+	dest->row = board->rows - turn->row - 1;
+	// if mirroring one of left/right, copy same.
+	// if mirroring one of top/bottom, flip it
+	dest->wall = turn->wall & LEFT_OR_RIGHT ? turn->wall : turn->wall ^ TOP_OR_BOTTOM;
+}
+DNB_STATIC void sym_rot_180(turn_t* turn, turn_t* dest, board_t* board){
+	dest->row = board->rows - turn->row - 1;
+	dest->col = board->cols - turn->col - 1;
+	// flip Left/Right or Top/Bottom
+	dest->wall = turn->wall & LEFT_OR_RIGHT ? turn->wall ^ LEFT_OR_RIGHT : turn->wall ^ TOP_OR_BOTTOM;
+}
+DNB_STATIC void sym_diag_tl_br(turn_t* turn, turn_t* dest, board_t* board){
+	dest->row = turn->col;
+	dest->col = turn->row;
+	// flip Left/Top or Right/Bottom
+	dest->wall = turn->wall & LEFT_OR_TOP ? turn->wall ^ LEFT_OR_TOP : turn->wall ^ RIGHT_OR_BOTTOM;
+}
+DNB_STATIC void sym_diag_tr_bl(turn_t* turn, turn_t* dest, board_t* board){
+	dest->row = board->cols - turn->col - 1;
+	dest->col = board->rows - turn->row - 1;
+	// flip Left/Bottom or Right/Top
+	dest->wall = turn->wall & LEFT_OR_BOTTOM ? turn->wall ^ LEFT_OR_BOTTOM : turn->wall ^ RIGHT_OR_TOP;
+}
+DNB_STATIC void sym_rot_90(turn_t* turn, turn_t* dest, board_t* board){
+	// composition of diagonal tl/br, then vertical flip
+	turn_t temp;
+	sym_diag_tl_br(turn, &temp, board);
+	sym_vertical(&temp, dest, board);
+}
+DNB_STATIC void sym_rot_270(turn_t* turn, turn_t* dest, board_t* board){
+	// composition of vertical flip, then diagonal tl/br
+	turn_t temp;
+	sym_vertical(turn, &temp, board);
+	sym_diag_tl_br(&temp, dest, board);
+}
+DNB_STATIC void symmetry(int type, turn_t* turn, turn_t* dest, board_t* board){
+	switch(type){
+	case HORIZONTAL:
+		sym_horizontal(turn, dest, board);
+		break;
+	case VERTICAL:
+		sym_vertical(turn, dest, board);
+		break;
+	case ROT_180:
+		sym_rot_180(turn, dest, board);
+		break;
+	// the following 4 symmetries only work for square boards, but we make no check here.
+	// it is the calling function's responsibility to only use valid symmetries
+	case ROT_90:
+		sym_rot_90(turn, dest, board);
+		break;
+	case ROT_270:
+		sym_rot_270(turn, dest, board);
+		break;
+	case DIAG_TL_BR:
+		sym_diag_tl_br(turn, dest, board);
+		break;
+	case DIAG_TR_BL:
+		sym_diag_tr_bl(turn, dest, board);
+		break;
 	}
-	c = fgetc(stdin);
-	while('0' <= c && c <= '9'){
-		cols *= 10;
-		cols += c-'0';
-		c = fgetc(stdin);
+}
+
+DNB_STATIC int n_walls(board_t* board){
+	return 2*board->rows*board->cols + board->rows + board->cols;
+}
+
+/* Walls are numbered independently of the dll so that playouts, search trees and tables can refer
+	to them with small integers. Horizontal walls come first (row-major over (rows+1) x cols), then
+	vertical walls (row-major over rows x (cols+1)). */
+DNB_STATIC int wall_index(int r, int c, wall_t typ, board_t* board){
+	int n_horizontal = (board->rows + 1) * board->cols;
+	switch(typ){
+	case TOP:
+		return r*board->cols + c;
+	case BOTTOM:
+		return (r+1)*board->cols + c;
+	case LEFT:
+		return n_horizontal + r*(board->cols+1) + c;
+	case RIGHT:
+		return n_horizontal + r*(board->cols+1) + c + 1;
+	}
+	return -1;
+}
+
+/* make the turn for one wall and file it under its wall index */
+DNB_STATIC turn_t* make_board_turn(int r, int c, wall_t wall, board_t* board){
+	int index = wall_index(r, c, wall, board);
+	turn_t* turn = make_turn_dll(board->sentinel + 1 + index, r, c, wall, index < MAX_UID_WALLS ? (bid_t)1 << index : 0);
+	turn->index = index;
+	board->turns[index] = turn;
+	return turn;
+}
+
+/* (re)build the dll from every turn not in 'drawn', always in the same order, so that searches
+	of the same position try turns in the same order however it was set up */
+DNB_STATIC void link_turns(board_t* board, bid_t drawn){
+	int rows = board->rows, cols = board->cols;
+	board->sentinel->next = board->sentinel;
+	board->sentinel->prev = board->sentinel;
+	for(int i=0; i<n_walls(board); ++i){
+		board->turns[i]->next = board->turns[i];
+		board->turns[i]->prev = board->turns[i];
+	}
+	// the order the turns were made in by init_board(), each inserted at the front
+	for(int r=0; r<rows; r++){
+		for(int c=0; c<cols; c++){
+			turn_t* left = board->turns[wall_index(r, c, LEFT, board)];
+			turn_t* top = board->turns[wall_index(r, c, TOP, board)];
+			if(!(drawn & left->uid)) add_turn_dll(board->sentinel, left);
+			if(!(drawn & top->uid)) add_turn_dll(board->sentinel, top);
+		}
+	}
+	for(int r=0; r<rows; r++){
+		turn_t* right = board->turns[wall_index(r, cols-1, RIGHT, board)];
+		if(!(drawn & right->uid)) add_turn_dll(board->sentinel, right);
 	}
+	for(int c=0; c<cols; c++){
+		turn_t* bottom = board->turns[wall_index(rows-1, c, BOTTOM, board)];
+		if(!(drawn & bottom->uid)) add_turn_dll(board->sentinel, bottom);
+	}
+}
 
-	int n_squares = rows * cols;
-	empty_board->squares = (square_t*) malloc(sizeof(square_t) * n_squares);
-	memset(empty_board->squares, 0, n_squares);
+/* set up an empty rows x cols board */
+DNB_STATIC void init_board(board_t* empty_board, int rows, int cols){
+	empty_board->rows = rows;
+	empty_board->cols = cols;
+	// the sentinel, then every turn by wall_index(), then the list of them and the squares: one
+	// allocation for everything whose count the size fixes, freed at once by cleanup()
+	int walls = n_walls(empty_board), n_squares = rows * cols;
+	turn_t* turns = (turn_t*) malloc(sizeof(turn_t) * (1 + walls) + sizeof(turn_t*) * walls + sizeof(square_t) * n_squares);
+	empty_board->block = turns;
+	empty_board->turns = (turn_t**) (turns + 1 + walls);
+	empty_board->squares = (square_t*) (empty_board->turns + walls);
+	memset(empty_board->squares, 0, sizeof(square_t) * n_squares);
 
 	// create sentinel DLL node
-	empty_board->sentinel = make_turn_dll(0, 0, 0);
+	empty_board->sentinel = make_turn_dll(turns, 0, 0, 0, 0);
 
 	// create all other valid turns
 	// step 1: left/top for all grid spaces
 	for(int r=0; r<rows; r++){
 		for(int c=0; c<cols; c++){
-			add_turn_dll(empty_board->sentinel, make_turn_dll(r, c, LEFT));
-			add_turn_dll(empty_board->sentinel, make_turn_dll(r, c, TOP));
+			make_board_turn(r, c, LEFT, empty_board);
+			make_board_turn(r, c, TOP, empty_board);
 		}
 	}
 	// step 2: fill in the rightmost walls
 	for(int r=0; r<rows; r++)
-		add_turn_dll(empty_board->sentinel, make_turn_dll(r, cols-1, RIGHT));
+		make_board_turn(r, cols-1, RIGHT, empty_board);
 	// step 3: fill in the bottommost walls
 	for(int c=0; c<cols; c++)
-		add_turn_dll(empty_board->sentinel, make_turn_dll(rows-1, c, BOTTOM));
+		make_board_turn(rows-1, c, BOTTOM, empty_board);
+	link_turns(empty_board, 0);
 
-	empty_board->rows = rows;
-	empty_board->cols = cols;
 	empty_board->player_turn = 0;
 	empty_board->scores[0] = 0;
 	empty_board->scores[1] = 0;
+	empty_board->uid = 0;
+	// square boards have extra symmetries (90- and 270-degree rotations and diagonal reflections)
+	empty_board->n_lists = rows == cols ? 8 : 4;
+	for(int s=0; s<MAX_SYMMETRIES; ++s) empty_board->asymmetry[s] = 0;
+	empty_board->memo_hashtable = NULL;
+	empty_board->memo_arena = NULL;
+	empty_board->memo_free = NULL;
+	empty_board->memo_count = 0;
+	empty_board->memo_shared = false;
+	empty_board->memo_generation = 0;
+	empty_board->memo_bits = HASHTABLE_BITWIDTH;
+	empty_board->solved = NULL;
+	empty_board->book = NULL;
+
+	// set up symmetric pairs
+	turn_t dummy;
+	for(turn_t* t=empty_board->sentinel->next; t != empty_board->sentinel; t = t->next){
+		for(int sym=1; sym < empty_board->n_lists; ++sym){
+			symmetry(sym, t, &dummy, empty_board);
+			// center of the board, things get symmetrical with themselves. check for it here
+			if(turn_equals(t, &dummy)) continue;
+			// find its pair (slow, but this function only gets called once, and n^2 << n!)
+			for(turn_t* cmp = empty_board->sentinel->next; cmp != empty_board->sentinel; cmp = cmp->next){
+				if(turn_equals(cmp, &dummy)){
+					t->pairs[sym] = cmp;
+					cmp->inverse_pairs[sym] = t;
+					break;
+				}
+			}
+		}
+	}
+
+#ifdef DEBUG
+	// sanity-check: every turn should be the image of exactly the turn its image came from
+	for(turn_t* t=empty_board->sentinel->next; t != empty_board->sentinel; t = t->next)
+		for(int sym=1; sym < empty_board->n_lists; ++sym)
+			if(t->pairs[sym] != NULL && t->pairs[sym]->inverse_pairs[sym] != t)
+				fprintf(stderr, "SYMMETRY ERROR: (%d,%d,%d) =%d=> (%d,%d,%d)\n", t->row, t->col, t->wall, sym, t->pairs[sym]->row, t->pairs[sym]->col, t->pairs[sym]->wall);
+#endif
+}
+
+DNB_STATIC void stdin_to_board(board_t* empty_board){
+	// assuming well-formed inputs
+	int rows = 0, cols = 0;
+	char c = fgetc(stdin);
+	while('0' <= c && c <= '9'){
+		rows *= 10;
+		rows += c-'0';
+		c = fgetc(stdin);
+	}
+	c = fgetc(stdin);
+	while('0' <= c && c <= '9'){
+		cols *= 10;
+		cols += c-'0';
+		c = fgetc(stdin);
+	}
+	init_board(empty_board, rows, cols);
 }
 
-bool game_is_over(board_t* board){
+DNB_STATIC bool game_is_over(board_t* board){
 	// game is over iff only the sentinel is left
 	return board->sentinel->next == board->sentinel;
 }
 
-int opposite(int r, int c, wall_t typ, board_t* board){
+/* get the index of the square on the other side of the specified wall (or -1 if it would be out of bounds) */
+DNB_STATIC int opposite(int r, int c, wall_t typ, board_t* board){
 	int i = r*board->cols + c; // flat index
 	switch(typ){
 	case TOP:
@@ -137,8 +571,33 @@ int opposite(int r, int c, wall_t typ, board_t* board){
 	return -1;
 }
 
+DNB_STATIC int count_sides(square_t s){
+	return (s & TOP ? 1 : 0) + (s & BOTTOM ? 1 : 0) + (s & LEFT ? 1 : 0) + (s & RIGHT ? 1 : 0);
+}
+
+/* number of boxes that playing 'turn' would complete, without playing it */
+DNB_STATIC int boxes_closed_by(turn_t* turn, board_t* board){
+	int i = turn->row*board->cols + turn->col; // flat index
+	int j = opposite(turn->row, turn->col, turn->wall, board);
+	// the same wall seen from the square on the other side
+	wall_t other = turn->wall & TOP_OR_BOTTOM ? turn->wall ^ TOP_OR_BOTTOM : turn->wall ^ LEFT_OR_RIGHT;
+	return (int)((board->squares[i] | turn->wall) == 0xF) + (int)(j > -1 && (board->squares[j] | other) == 0xF);
+}
+
+/* rough quality of a turn before searching it: 2 if it completes a box, 1 if it is safe (puts a
+	third side on no box), 0 if it hands the opponent a box */
+DNB_STATIC int turn_priority(turn_t* turn, board_t* board){
+	int i = turn->row*board->cols + turn->col;
+	int j = opposite(turn->row, turn->col, turn->wall, board);
+	int si = count_sides(board->squares[i]);
+	int sj = j > -1 ? count_sides(board->squares[j]) : 0;
+	if(si == 3 || sj == 3) return 2;
+	if(si < 2 && sj < 2) return 1;
+	return 0;
+}
+
 /* add a wall and return the number of completed boxes*/
-int add_wall(int r, int c, wall_t typ, board_t* board){
+DNB_STATIC int add_wall(int r, int c, wall_t typ, board_t* board){
 	int i = r*board->cols + c; // flat index
 	board->squares[i] |= typ;
 
@@ -163,7 +622,7 @@ int add_wall(int r, int c, wall_t typ, board_t* board){
 }
 
 /* remove wall and return the number of un-done boxes */
-int remove_wall(int r, int c, wall_t typ, board_t* board){
+DNB_STATIC int remove_wall(int r, int c, wall_t typ, board_t* board){
 	int i = r*board->cols + c; // flat index
 	int j = opposite(r, c, typ, board);
 	int undone_boxes = (int)(board->squares[i] == 0xF) + (int)(j > -1 && board->squares[j] == 0xF);
@@ -187,7 +646,7 @@ int remove_wall(int r, int c, wall_t typ, board_t* board){
 	return undone_boxes;
 }
 
-void print_board(board_t* board){
+DNB_STATIC void print_board(board_t* board){
 	for(int r=0; r<board->rows; r++){
 		for(int c=0; c<board->cols; c++){
 			int i = r*board->cols + c; // flat index
@@ -198,37 +657,445 @@ void print_board(board_t* board){
 	printf("%d : %d\n", board->scores[0], board->scores[1]);
 }
 
-void execute_turn(turn_t* turn, board_t* board){
+DNB_STATIC void execute_turn(turn_t* turn, board_t* board){
 	int closed_boxes = add_wall(turn->row, turn->col, turn->wall, board);
 	if(closed_boxes > 0){
 		board->scores[board->player_turn] += closed_boxes;
 	} else{
 		board->player_turn = 1 - board->player_turn;
 	}
+	board->uid |= turn->uid;
 }
 
-void unexecute_turn(turn_t* turn, board_t* board){
+DNB_STATIC void unexecute_turn(turn_t* turn, board_t* board){
 	int opened_boxes = remove_wall(turn->row, turn->col, turn->wall, board);
 	if(opened_boxes > 0){
 		board->scores[board->player_turn] -= opened_boxes;
 	} else{
 		board->player_turn = 1 - board->player_turn;
 	}
+	board->uid &= ~turn->uid;
+}
+
+/* keep board->asymmetry up to date after 'turn' was executed. a drawn wall only breaks
+	symmetry s while its image under s is undrawn */
+DNB_STATIC void play_symmetries(turn_t* turn, board_t* board){
+	for(int s=1; s<board->n_lists; ++s){
+		turn_t* image = turn->pairs[s];
+		turn_t* preimage = turn->inverse_pairs[s];
+		// the new wall breaks the symmetry until its image is drawn too...
+		if(image != NULL && !(board->uid & image->uid)) board->asymmetry[s]++;
+		// ...and it may be the missing image of a wall drawn earlier
+		if(preimage != NULL && (board->uid & preimage->uid)) board->asymmetry[s]--;
+	}
+}
+
+/* exact inverse of play_symmetries() */
+DNB_STATIC void unplay_symmetries(turn_t* turn, board_t* board){
+	for(int s=1; s<board->n_lists; ++s){
+		turn_t* image = turn->pairs[s];
+		turn_t* preimage = turn->inverse_pairs[s];
+		if(image != NULL && !(board->uid & image->uid)) board->asymmetry[s]--;
+		if(preimage != NULL && (board->uid & preimage->uid)) board->asymmetry[s]++;
+	}
 }
 
-void cleanup(board_t* board){
-	free(board->squares);
-	// free DLL
-	while(board->sentinel->next != board->sentinel){
-		turn_t* rem = board->sentinel->next;
-		remove_turn_dll(rem);
-		free(rem);
+DNB_STATIC bool has_symmetry(board_t* board, int sym){
+	return board->asymmetry[sym] == 0;
+}
+
+/* the walls 'uid' after symmetry 'sym' */
+DNB_STATIC bid_t symmetric_uid(board_t* board, bid_t uid, int sym){
+	bid_t image = 0;
+	for(bid_t rest = uid; rest != 0; rest &= rest - 1){
+		turn_t* t = board->turns[__builtin_ctzll(rest)];
+		image |= t->pairs[sym] != NULL ? t->pairs[sym]->uid : t->uid;
+	}
+	return image;
+}
+
+/* the same uid for a position and all of its symmetric images (the smallest of them), and in
+	'sym' the symmetry that takes this one there */
+DNB_STATIC bid_t canonical_uid(board_t* board, bid_t uid, int* sym){
+	bid_t canonical = uid;
+	*sym = 0;
+	for(int s=1; s<board->n_lists; ++s){
+		bid_t image = symmetric_uid(board, uid, s);
+		if(image < canonical){
+			canonical = image;
+			*sym = s;
+		}
+	}
+	return canonical;
+}
+
+/* put a board (of at most MAX_UID_WALLS walls) in the position with the walls of 'drawn' (bits
+	by wall_index()), whatever position it was in before. the scores and the player to move are
+	not implied by the walls, so they are given too. the table, if any, stays: its entries only
+	depend on the walls */
+DNB_STATIC void set_position(board_t* board, bid_t drawn, int score0, int score1, int player){
+	memset(board->squares, 0, sizeof(square_t) * board->rows * board->cols);
+	board->uid = 0;
+	for(int s=0; s<MAX_SYMMETRIES; ++s) board->asymmetry[s] = 0;
+	for(int i=0; i<n_walls(board); ++i){
+		turn_t* t = board->turns[i];
+		if(!(drawn & t->uid)) continue;
+		add_wall(t->row, t->col, t->wall, board);
+		board->uid |= t->uid;
+		// the asymmetry counts only depend on the set of walls, not the order they came in
+		play_symmetries(t, board);
+	}
+	link_turns(board, drawn);
+	board->scores[0] = score0;
+	board->scores[1] = score1;
+	board->player_turn = player;
+}
+
+/* a position from its text form, see position_t; "rows cols" alone is the start of a game. false
+	if it does not parse, which says nothing about whether it is a valid position */
+DNB_STATIC bool parse_position(const char* text, position_t* position){
+	position_t p = {0, 0, 0, {0, 0}, 0};
+	char* end;
+	p.rows = (int) strtol(text, &end, 10);
+	if(end == text) return false;
+	text = end;
+	p.cols = (int) strtol(text, &end, 10);
+	if(end == text) return false;
+	text = end;
+	// the rest is optional
+	p.walls = strtoull(text, &end, 16);
+	if(end != text){
+		text = end;
+		long int fields[3];
+		for(int k=0; k<3; ++k){
+			fields[k] = strtol(text, &end, 10);
+			if(end == text) return false;
+			text = end;
+		}
+		p.scores[0] = (int) fields[0];
+		p.scores[1] = (int) fields[1];
+		p.player = (int) fields[2];
 	}
-	free(board->sentinel);
+	while(*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n') ++text;
+	if(*text != '\0') return false;
+	*position = p;
+	return true;
+}
+
+/* the text form of 'position', like snprintf() */
+DNB_STATIC int format_position(const position_t* position, char* text, int size){
+	return snprintf(text, size, "%d %d %llx %d %d %d", position->rows, position->cols,
+		(unsigned long long) position->walls, position->scores[0], position->scores[1], position->player);
+}
+
+/* boxes with all four walls */
+DNB_STATIC int boxes_closed(board_t* board){
+	int n = 0;
+	for(int i=0; i<board->rows * board->cols; ++i) n += board->squares[i] == 0xF;
+	return n;
+}
+
+// smallest table put in huge pages (memo_is_huge())
+#define HUGE_MEMO_BITS 22
+
+/* whether the board's table goes in huge pages: only a big one, on a board with enough positions
+	to fill it. small solves touch a few buckets here and there, and would pay for zeroing a whole
+	huge page at each */
+DNB_STATIC bool memo_is_huge(board_t* board){
+	return board->memo_bits >= HUGE_MEMO_BITS && n_walls(board) >= board->memo_bits;
+}
+
+/* an empty table for the board, with at least as many buckets as it needs for the uids to fit in
+	entries: 2^(walls - MEMO_KEY_BITS) */
+DNB_STATIC void init_memo(board_t* board){
+	int walls = n_walls(board) < MAX_UID_WALLS ? n_walls(board) : MAX_UID_WALLS;
+	if(board->memo_bits < walls - MEMO_KEY_BITS) board->memo_bits = walls - MEMO_KEY_BITS;
+	bool huge = memo_is_huge(board);
+	size_t bytes = sizeof(memo_t*) << board->memo_bits;
+	board->memo_hashtable = (memo_t**) (huge ? huge_alloc(bytes) : calloc(1, bytes));
+	board->memo_arena = (arena_t*) calloc(1, sizeof(arena_t));
+	board->memo_arena->huge = huge;
+	board->memo_slab.next = board->memo_slab.end = NULL;
+	board->memo_free = NULL;
+}
+
+DNB_STATIC bid_t hash(board_t* board){
+	bid_t mask = ((bid_t) 1 << board->memo_bits) - 1;
+	return board->uid & mask;
+}
+
+/* what an entry keeps of 'uid': the bits above its bucket */
+DNB_STATIC bid_t memo_key(board_t* board, bid_t uid){
+	return uid >> board->memo_bits;
+}
+
+DNB_STATIC bool memo_is(const memo_t* m, bid_t key){
+	return m->key == (uint32_t) key && m->key_high == (key >> 32);
+}
+
+DNB_STATIC void set_memo_key(memo_t* m, bid_t key){
+	m->key = (uint32_t) key;
+	m->key_high = (unsigned int) (key >> 32);
+}
+
+/* the uid of entry 'm', in bucket 'bucket' */
+DNB_STATIC bid_t memo_uid(board_t* board, const memo_t* m, bid_t bucket){
+	return ((((bid_t) m->key_high << 32) | m->key) << board->memo_bits) | bucket;
+}
+
+/* the board's own table only */
+DNB_STATIC memo_t* probe_table(board_t* board, bid_t uid){
+	bid_t mask = ((bid_t) 1 << board->memo_bits) - 1;
+	bid_t key = memo_key(board, uid);
+	// entries are complete before they are linked in (write_memo()), and the links never change
+	memo_t* lookup = __atomic_load_n(&board->memo_hashtable[uid & mask], __ATOMIC_ACQUIRE);
+	COUNT(long int length = 0;)
+	while(lookup != NULL && !memo_is(lookup, key)){
+		lookup = lookup->next;
+		COUNT(length++;)
+	}
+	COUNT(board->memo_collisions += length;
+		length += lookup != NULL;
+		board->memo_walked += length;
+		board->memo_chains[length < MEMO_CHAINS ? length : MEMO_CHAINS - 1]++;
+		if(length > board->memo_chain_max) board->memo_chain_max = length;)
+	return lookup;
+}
+
+/* start loading the bucket of 'uid', e.g. a child's as soon as its turn is chosen, so that the
+	probe_table() after the turn finds it in the cache */
+DNB_STATIC void prefetch_memo(board_t* board, bid_t uid){
+	bid_t mask = ((bid_t) 1 << board->memo_bits) - 1;
+	__builtin_prefetch(&board->memo_hashtable[uid & mask]);
+}
+
+/* slot of 'uid' in a table of solved positions, before probing on */
+DNB_STATIC bid_t solved_slot(bid_t uid, int bits){
+	return bits > 0 ? (uid * 0x9E3779B97F4A7C15ULL) >> (64 - bits) : 0;
+}
+
+/* the board's table of solved positions only, as a memo entry in board->solved_hit */
+DNB_STATIC memo_t* probe_solved(board_t* board, bid_t uid){
+	const solved_db_t* db = board->solved;
+	if(__builtin_popcountll(uid) > db->max_walls) return NULL;
+	bid_t mask = ((bid_t) 1 << db->bits) - 1;
+	for(bid_t i = solved_slot(uid, db->bits); ; i = (i + 1) & mask){
+		const solved_t* e = &db->slots[i];
+		if(e->uid == SOLVED_EMPTY) return NULL;
+		if(e->uid != uid) continue;
+		memo_t* hit = &board->solved_hit;
+		hit->value = e->value;
+		hit->bound = e->bound;
+		hit->best_move = e->best_move;
+		hit->next = NULL;
+		return hit;
+	}
+}
+
+/* the board's opening book only, as a memo entry in board->solved_hit */
+DNB_STATIC memo_t* probe_book(board_t* board, bid_t uid){
+	const book_t* book = board->book;
+	if(__builtin_popcountll(uid) > book->plies) return NULL;
+	int sym;
+	bid_t key = canonical_uid(board, uid, &sym);
+	long int low = 0, high = book->entries;
+	while(low < high){
+		long int middle = low + (high - low) / 2;
+		if(book->uids[middle] < key) low = middle + 1;
+		else high = middle;
+	}
+	if(low == book->entries || book->uids[low] != key) return NULL;
+	// the book's turn is one in the canonical position: take it back to this one
+	turn_t* best = board->turns[book->moves[low].best_move];
+	if(sym != 0 && best->inverse_pairs[sym] != NULL) best = best->inverse_pairs[sym];
+	memo_t* hit = &board->solved_hit;
+	hit->value = book->moves[low].value;
+	hit->bound = BOUND_EXACT;
+	hit->best_move = best->index;
+	hit->next = NULL;
+	return hit;
+}
+
+/* look up any position by its uid, e.g. a child's (board->uid | turn->uid): in the board's table,
+	then in its opening book and its table of solved positions. what comes from those is only good
+	until the next look */
+DNB_STATIC memo_t* probe_memo(board_t* board, bid_t uid){
+	memo_t* lookup = probe_table(board, uid);
+	if(lookup == NULL && board->book != NULL) lookup = probe_book(board, uid);
+	if(lookup == NULL && board->solved != NULL) lookup = probe_solved(board, uid);
+	return lookup;
+}
+
+DNB_STATIC memo_t* read_memo(board_t* board){
+	memo_t* found = probe_memo(board, board->uid);
+	// still in use. entries of a shared table never change (see write_memo())
+	if(found != NULL && !board->memo_shared) found->generation = board->memo_generation;
+	return found;
+}
+
+DNB_STATIC void write_memo(board_t* board, int value, int bound, turn_t* best){
+	int index = hash(board);
+	memo_t* lookup = probe_table(board, board->uid);
+	if(lookup != NULL && !board->memo_shared){
+		// likely redundant, but strictly write_memo should overwrite
+		lookup->value = value;
+		lookup->bound = bound;
+		lookup->best_move = best->index;
+		lookup->generation = board->memo_generation;
+		return;
+	}
+	// not found (or shared, where another thread could be reading the old entry: the new one goes
+	// in front of it instead); make new one, in place of an aged one if there is any
+	memo_t* new_memo = board->memo_free;
+	if(new_memo != NULL) board->memo_free = new_memo->next;
+	else new_memo = (memo_t*) arena_alloc(board->memo_arena, &board->memo_slab, sizeof(memo_t));
+	// out of memory: the position goes unremembered, which only costs a search
+	if(new_memo == NULL) return;
+	board->memo_count++;
+	set_memo_key(new_memo, memo_key(board, board->uid));
+	new_memo->value = value;
+	new_memo->bound = bound;
+	new_memo->best_move = best->index;
+	new_memo->generation = board->memo_generation;
+	// other threads may be linking entries into a shared bucket meanwhile
+	new_memo->next = __atomic_load_n(&board->memo_hashtable[index], __ATOMIC_RELAXED);
+	if(!board->memo_shared){
+		board->memo_hashtable[index] = new_memo;
+		return;
+	}
+	// publish it only once it is complete; on failure, next is reloaded with the new head
+	while(!__atomic_compare_exchange_n(&board->memo_hashtable[index], &new_memo->next, new_memo, true,
+		__ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/* the same bound seen from the other player's side */
+DNB_STATIC int flip_bound(int bound){
+	return bound == BOUND_EXACT ? BOUND_EXACT : 3 - bound;
+}
+
+/* number of positions in the table */
+DNB_STATIC long int memo_entries(board_t* board){
+	long int n = 0;
+	if(board->memo_hashtable == NULL) return 0;
+	for(long int i=0; i<(1L<<board->memo_bits); ++i)
+		for(memo_t* m = board->memo_hashtable[i]; m != NULL; m = m->next)
+			++n;
+	return n;
+}
+
+/* drop the board's table: free it, unless it is shared, which only lets go of it. the entries
+	go with their arena, without a walk of the chains */
+DNB_STATIC void free_memo(board_t* board){
+	if(board->memo_hashtable != NULL && !board->memo_shared){
+		if(board->memo_arena->huge) huge_free(board->memo_hashtable, sizeof(memo_t*) << board->memo_bits);
+		else free(board->memo_hashtable);
+		arena_release(board->memo_arena);
+		free(board->memo_arena);
+	}
+	board->memo_hashtable = NULL;
+	board->memo_arena = NULL;
+	board->memo_slab.next = board->memo_slab.end = NULL;
+	board->memo_free = NULL;
+	board->memo_count = 0;
+	board->memo_shared = false;
+}
+
+/* drop the entries last used before generation 'oldest' (see memo_generation), e.g. to keep a
+	table that lives through many searches in bounds: write_memo() uses them again before it takes
+	more of the arena. returns how many. not for shared tables. entries only keep the generation
+	modulo 256, i.e. how many generations back they were used, so 'oldest' must be less than 256
+	back, and an entry not used for 256 generations looks new again */
+DNB_STATIC long int age_memo(board_t* board, int oldest){
+	long int freed = 0;
+	if(board->memo_hashtable == NULL || board->memo_shared) return 0;
+	int keep = board->memo_generation - oldest; // how far back
+	for(long int i=0; i<(1L<<board->memo_bits); ++i){
+		for(memo_t** link = &board->memo_hashtable[i]; *link != NULL; ){
+			memo_t* m = *link;
+			if(((board->memo_generation - (int) m->generation) & 0xFF) <= keep){
+				link = &m->next;
+				continue;
+			}
+			*link = m->next;
+			m->next = board->memo_free;
+			board->memo_free = m;
+			++freed;
+		}
+	}
+	board->memo_count -= freed;
+	return freed;
+}
+
+/* use the table of 'owner' (another board of the same size) in place of the board's own, from
+	any number of threads at once: entries are then only ever added, never changed in place, so
+	nobody reads half of one. the owner frees it, once no board shares it any more */
+DNB_STATIC void share_memo(board_t* board, const board_t* owner){
+	free_memo(board);
+	board->memo_hashtable = owner->memo_hashtable;
+	board->memo_bits = owner->memo_bits;
+	// new entries go in the owner's arena, from a slab of this board's
+	board->memo_arena = owner->memo_arena;
+	board->memo_shared = true;
+}
+
+DNB_STATIC void cleanup(board_t* board){
+	// every turn, whether it is still in the dll or was drawn (set_position()), and the squares
+	free(board->block);
+	free_memo(board);
+}
+
+/* a new board in the position in 'text' (parse_position()). false, with no board, if that is not
+	a position on a board of its size */
+DNB_STATIC bool text_to_board(const char* text, board_t* board){
+	position_t p;
+	if(!parse_position(text, &p) || p.rows < 1 || p.cols < 1 || p.player < 0 || p.player > 1 || p.scores[0] < 0
+		|| p.scores[1] < 0) return false;
+	int walls = 2*p.rows*p.cols + p.rows + p.cols;
+	if(p.walls != 0 && (walls > MAX_UID_WALLS || (walls < MAX_UID_WALLS && (p.walls >> walls) != 0))) return false;
+	init_board(board, p.rows, p.cols);
+	set_position(board, p.walls, p.scores[0], p.scores[1], p.player);
+	// every box taken was taken by somebody
+	if(boxes_closed(board) == p.scores[0] + p.scores[1]) return true;
+	cleanup(board);
+	return false;
+}
+
+/* monotonic wall-clock time in milliseconds */
+DNB_STATIC double now_ms(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/* small, well-mixed random numbers from a counter (hash keys, seeds) */
+DNB_STATIC uint64_t splitmix64(uint64_t* s){
+	uint64_t z = (*s += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/* cheap guess of the final margin for the player to move, used to centre the aspiration window:
+	the margin so far, and with an odd number of boxes left somebody has to come out ahead, on
+	small boards usually the player not to move */
+DNB_STATIC int predict_margin(board_t* board){
+	int p = board->player_turn;
+	int left = board->rows * board->cols - board->scores[0] - board->scores[1];
+	return board->scores[p] - board->scores[1-p] - left % 2;
+}
+
+DNB_STATIC const char* wall_name(wall_t wall){
+	switch(wall){
+	case TOP: return "TOP";
+	case BOTTOM: return "BOTTOM";
+	case LEFT: return "LEFT";
+	case RIGHT: return "RIGHT";
+	}
+	return "";
 }
 
 /* generic printouts at end */
-void stats(board_t* board, turn_t* best_turn, int best_outcome, long int count_turns){
+DNB_STATIC void stats(board_t* board, turn_t* best_turn, int best_outcome, long int count_turns){
 	if(best_outcome > 0)
 		printf("win\n");
 	else if(best_outcome < 0)
@@ -236,28 +1103,14 @@ void stats(board_t* board, turn_t* best_turn, int best_outcome, long int count_t
 	else
 		printf("draw\n");
 
-	char* typ = "";
-	switch(best_turn->wall){
-	case TOP:
-		typ = "TOP";
-		break;
-	case BOTTOM:
-		typ = "BOTTOM";
-		break;
-	case LEFT:
-		typ = "LEFT";
-		break;
-	case RIGHT:
-		typ = "RIGHT";
-		break;
-	}
-	printf("best option: %d %d %s\n", best_turn->row, best_turn->col, typ);
+	printf("best option: %d %d %s\n", best_turn->row, best_turn->col, wall_name(best_turn->wall));
 	printf("with score %d\n", best_outcome);
 
-	long int nwalls = board->rows*board->cols*2 + board->rows + board->cols;
-	long int fact = 1, s = 0;
+	long int nwalls = n_walls(board);
+	// far beyond a long past 2x3
+	double fact = 1, s = 0;
 	for(long int i=nwalls; i>0; --i){fact *= i; s += fact; }
 	printf("%ld walls\n", nwalls);
-	printf("%ld search-space branches\n", s);
+	printf("%.4g search-space branches\n", s);
 	printf("%ld turns taken\n", count_turns);
 }
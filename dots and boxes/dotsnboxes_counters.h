@@ -0,0 +1,70 @@
+#include <sys/resource.h>
+
+/* Search counters, for looking inside a solve rather than just timing it. They only exist when
+	built with -DCOUNTERS ("make counters"): otherwise COUNT(...) (dotsnboxes.h) drops its
+	argument, so the engine compiles exactly as if they were not there. The table's are kept by
+	probe_table() in the board, as it walks the bucket anyway. */
+
+// a search is never deeper than the number of walls
+#define MAX_DEPTH (MAX_UID_WALLS + 1)
+
+typedef struct Counters{
+	long int nodes[MAX_DEPTH];      // turns executed, by depth of the position they lead to
+	long int cutoffs[MAX_DEPTH];    // alpha-beta cutoffs, by how many turns the node had searched
+	long int memo_peak;             // most entries the table held at once (age_memo() drops some)
+	long int sym_prunes[MAX_SYMMETRIES]; // turns skipped as mirror images, by symmetry
+} counters_t;
+
+#ifdef COUNTERS
+DNB_STATIC void counters_init(counters_t* c, board_t* board){
+	memset(c, 0, sizeof(counters_t));
+	memset(board->memo_chains, 0, sizeof(board->memo_chains));
+	board->memo_walked = 0;
+	board->memo_collisions = 0;
+	board->memo_chain_max = 0;
+}
+
+/* after an entry is written */
+DNB_STATIC void counters_store(counters_t* c, board_t* board){
+	if(board->memo_count > c->memo_peak) c->memo_peak = board->memo_count;
+}
+
+/* largest resident set of the process so far, in KB */
+DNB_STATIC long int peak_rss_kb(){
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+	return usage.ru_maxrss;
+}
+
+/* printouts after stats() */
+DNB_STATIC void print_counters(counters_t* c, board_t* board, long int memo_probes, long int memo_hits, long int memo_stored){
+	const char* names[MAX_SYMMETRIES] = {"", "horizontal", "vertical", "rot_180", "rot_90", "rot_270", "diag_tl_br", "diag_tr_bl"};
+	printf("nodes per depth:");
+	for(int d=0; d<MAX_DEPTH; ++d)
+		if(c->nodes[d]) printf(" %d:%ld", d, c->nodes[d]);
+	printf("\n");
+	long int cutoffs = 0;
+	for(int k=0; k<MAX_DEPTH; ++k) cutoffs += c->cutoffs[k];
+	printf("cutoffs per move index:");
+	for(int k=0; k<MAX_DEPTH; ++k)
+		if(c->cutoffs[k]) printf(" %d:%ld", k, c->cutoffs[k]);
+	// with perfect ordering every cutoff comes from the first turn searched
+	printf("\n%.1f%% of %ld cutoffs on the first move\n", cutoffs ? 100.0 * c->cutoffs[0] / cutoffs : 0.0, cutoffs);
+	printf("memo: %ld probes, %ld hits\n", memo_probes, memo_hits);
+	// stores walk the bucket too, before linking in a new entry
+	long int walks = 0;
+	for(int k=0; k<MEMO_CHAINS; ++k) walks += board->memo_chains[k];
+	printf("memo chains: %ld walks (probes and stores), %.2f entries each, %ld collisions, longest %ld\n", walks,
+		walks ? (double) board->memo_walked / walks : 0.0, board->memo_collisions, board->memo_chain_max);
+	printf("memo chain lengths:");
+	for(int k=0; k<MEMO_CHAINS; ++k)
+		if(board->memo_chains[k]) printf(" %d%s:%ld", k, k == MEMO_CHAINS - 1 ? "+" : "", board->memo_chains[k]);
+	printf("\n");
+	printf("memo: %ld entries stored, at most %ld at once, %.2f per bucket\n", memo_stored, c->memo_peak,
+		(double) c->memo_peak / (1L << board->memo_bits));
+	printf("symmetry prunes:");
+	for(int s=1; s<MAX_SYMMETRIES; ++s)
+		if(c->sym_prunes[s]) printf(" %s:%ld", names[s], c->sym_prunes[s]);
+	printf("\npeak rss: %ld KB\n", peak_rss_kb());
+}
+#endif
@@ -0,0 +1,236 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* Tables of solved positions on disk, for many processes and boards to look up at once
+	(board->solved, see probe_memo()): the entries of one board size's table, written once by
+	db_write() and then only ever mapped read-only, so every process that opens the same file
+	shares one copy of it in the page cache. Opening books (board->book, see probe_book()) are
+	files of the same kind.
+
+	The file is a db_header_t and then 2^bits solved_t slots, open addressing from solved_slot()
+	with linear probing, at most half of them used so that a miss stops early. Entries keep their
+	bounds: a lower or upper bound is as good here as it was in the table it came from. */
+
+#define DB_MAGIC "DNBSOLVD"
+#define DB_VERSION 1
+
+typedef struct DbHeader{
+	char magic[8];
+	int32_t version;
+	int32_t rows, cols;
+	int32_t bits;
+	int32_t max_walls;
+	int32_t unused;
+	int64_t entries;
+} db_header_t;
+
+/* write the entries of the board's table for positions with at most 'max_walls' walls drawn to
+	'path'. false if it could not */
+DNB_STATIC bool db_write(board_t* board, int max_walls, const char* path){
+	if(max_walls > n_walls(board)) max_walls = n_walls(board);
+	long int entries = 0;
+	for(long int i=0; i<(1L<<board->memo_bits); ++i)
+		for(memo_t* m = board->memo_hashtable[i]; m != NULL; m = m->next)
+			entries += __builtin_popcountll(memo_uid(board, m, i)) <= max_walls;
+	int bits = 1;
+	while((1L << bits) < 2 * entries) ++bits;
+	bid_t mask = ((bid_t) 1 << bits) - 1;
+	solved_t* slots = (solved_t*) malloc(sizeof(solved_t) << bits);
+	if(slots == NULL) return false;
+	for(bid_t i=0; i<=mask; ++i) slots[i].uid = SOLVED_EMPTY;
+	for(long int i=0; i<(1L<<board->memo_bits); ++i){
+		for(memo_t* m = board->memo_hashtable[i]; m != NULL; m = m->next){
+			bid_t uid = memo_uid(board, m, i);
+			if(__builtin_popcountll(uid) > max_walls) continue;
+			bid_t s = solved_slot(uid, bits);
+			while(slots[s].uid != SOLVED_EMPTY) s = (s + 1) & mask;
+			slots[s].uid = uid;
+			slots[s].value = (int16_t) m->value;
+			slots[s].bound = (uint8_t) m->bound;
+			slots[s].best_move = (uint8_t) m->best_move;
+			slots[s].unused = 0;
+		}
+	}
+	db_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, DB_MAGIC, sizeof(header.magic));
+	header.version = DB_VERSION;
+	header.rows = board->rows;
+	header.cols = board->cols;
+	header.bits = bits;
+	header.max_walls = max_walls;
+	header.entries = entries;
+	FILE* f = fopen(path, "wb");
+	bool ok = f != NULL && fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(slots, sizeof(solved_t), mask + 1, f) == mask + 1;
+	if(f != NULL && fclose(f) != 0) ok = false;
+	free(slots);
+	return ok;
+}
+
+/* map the table in 'path' into 'db'. null if fine, otherwise what is wrong with it */
+DNB_STATIC const char* db_open(solved_db_t* db, const char* path){
+	memset(db, 0, sizeof(*db));
+	int fd = open(path, O_RDONLY);
+	if(fd < 0) return "cannot open it";
+	struct stat st;
+	db_header_t header;
+	const char* error = NULL;
+	if(fstat(fd, &st) != 0 || read(fd, &header, sizeof(header)) != sizeof(header)) error = "cannot read it";
+	else if(memcmp(header.magic, DB_MAGIC, sizeof(header.magic)) != 0 || header.version != DB_VERSION) error = "not a table of solved positions";
+	else if(header.bits < 1 || header.bits > 40 || (size_t) st.st_size != sizeof(header) + (sizeof(solved_t) << header.bits)) error = "truncated";
+	else{
+		db->map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if(db->map == MAP_FAILED){
+			db->map = NULL;
+			error = "cannot map it";
+		}
+	}
+	close(fd);
+	if(error != NULL) return error;
+	db->map_size = st.st_size;
+	db->slots = (const solved_t*) ((char*) db->map + sizeof(header));
+	db->bits = header.bits;
+	db->entries = (long int) header.entries;
+	db->rows = header.rows;
+	db->cols = header.cols;
+	db->max_walls = header.max_walls;
+	return NULL;
+}
+
+DNB_STATIC void db_close(solved_db_t* db){
+	if(db->map != NULL) munmap(db->map, db->map_size);
+	memset(db, 0, sizeof(*db));
+}
+
+/* the one of 'n' tables for boards of this size, or null */
+DNB_STATIC const solved_db_t* db_find(const solved_db_t* dbs, int n, int rows, int cols){
+	for(int i=0; i<n; ++i)
+		if(dbs[i].rows == rows && dbs[i].cols == cols) return &dbs[i];
+	return NULL;
+}
+
+/* an opening book's file is a book_header_t, then the canonical uids in ascending order, then a
+	book_move_t for each */
+#define BOOK_MAGIC "DNBBOOK"
+#define BOOK_VERSION 1
+
+typedef struct BookHeader{
+	char magic[8];
+	int32_t version;
+	int32_t rows, cols;
+	int32_t plies;
+	int64_t entries;
+} book_header_t;
+
+/* write a book for boards of the given size to 'path', from 'entries' positions sorted by uid.
+	false if it could not */
+DNB_STATIC bool book_write(int rows, int cols, int plies, const bid_t* uids, const book_move_t* moves, long int entries, const char* path){
+	book_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+	header.version = BOOK_VERSION;
+	header.rows = rows;
+	header.cols = cols;
+	header.plies = plies;
+	header.entries = entries;
+	FILE* f = fopen(path, "wb");
+	bool ok = f != NULL && fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(uids, sizeof(bid_t), entries, f) == (size_t) entries
+		&& fwrite(moves, sizeof(book_move_t), entries, f) == (size_t) entries;
+	if(f != NULL && fclose(f) != 0) ok = false;
+	return ok;
+}
+
+/* map the book in 'path' into 'book'. null if fine, otherwise what is wrong with it */
+DNB_STATIC const char* book_open(book_t* book, const char* path){
+	memset(book, 0, sizeof(*book));
+	int fd = open(path, O_RDONLY);
+	if(fd < 0) return "cannot open it";
+	struct stat st;
+	book_header_t header;
+	const char* error = NULL;
+	if(fstat(fd, &st) != 0 || read(fd, &header, sizeof(header)) != sizeof(header)) error = "cannot read it";
+	else if(memcmp(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 || header.version != BOOK_VERSION) error = "not an opening book";
+	else if(header.entries <= 0) error = "empty";
+	else if((size_t) st.st_size != sizeof(header) + header.entries * (sizeof(bid_t) + sizeof(book_move_t))) error = "truncated";
+	else{
+		book->map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if(book->map == MAP_FAILED){
+			book->map = NULL;
+			error = "cannot map it";
+		}
+	}
+	close(fd);
+	if(error != NULL) return error;
+	book->map_size = st.st_size;
+	book->entries = (long int) header.entries;
+	book->uids = (const bid_t*) ((char*) book->map + sizeof(header));
+	book->moves = (const book_move_t*) (book->uids + header.entries);
+	book->rows = header.rows;
+	book->cols = header.cols;
+	book->plies = header.plies;
+	return NULL;
+}
+
+DNB_STATIC void book_close(book_t* book){
+	if(book->map != NULL) munmap(book->map, book->map_size);
+	memset(book, 0, sizeof(*book));
+}
+
+/* the one of 'n' books for boards of this size, or null */
+DNB_STATIC const book_t* book_find(const book_t* books, int n, int rows, int cols){
+	for(int i=0; i<n; ++i)
+		if(books[i].rows == rows && books[i].cols == cols) return &books[i];
+	return NULL;
+}
+
+/* positions to solve for a book (solver_book) or to hand out as work (solver_dist) */
+typedef struct BookPosition{
+	bid_t uid; // canonical
+	int scores[2];
+	int player;
+	int value, best; // swing and wall_index(), once solved
+} book_position_t;
+
+typedef struct BookPositions{
+	book_position_t* at;
+	long int n, size;
+} book_positions_t;
+
+/* every position, by its canonical_uid(), up to 'plies' more turns from the board's, into 'out'
+	(with repeats) */
+DNB_STATIC void book_collect(board_t* board, int plies, book_positions_t* out){
+	if(out->n == out->size){
+		out->size = out->size ? 2 * out->size : 1024;
+		out->at = (book_position_t*) realloc(out->at, sizeof(book_position_t) * out->size);
+	}
+	book_position_t* p = &out->at[out->n++];
+	int sym;
+	p->uid = canonical_uid(board, board->uid, &sym);
+	p->scores[0] = board->scores[0];
+	p->scores[1] = board->scores[1];
+	p->player = board->player_turn;
+	if(plies == 0) return;
+	for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next){
+		execute_turn(t, board);
+		turn_t* memo = remove_turn_dll(t);
+		book_collect(board, plies - 1, out);
+		add_turn_dll(memo, t);
+		unexecute_turn(t, board);
+	}
+}
+
+DNB_STATIC int by_book_uid(const void* a, const void* b){
+	bid_t x = ((const book_position_t*) a)->uid, y = ((const book_position_t*) b)->uid;
+	return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/* sort the positions by uid and keep one of each. how many that leaves */
+DNB_STATIC long int book_unique(book_positions_t* positions){
+	qsort(positions->at, positions->n, sizeof(book_position_t), by_book_uid);
+	long int n = 0;
+	for(long int i=0; i<positions->n; ++i)
+		if(n == 0 || positions->at[i].uid != positions->at[n-1].uid) positions->at[n++] = positions->at[i];
+	return positions->n = n;
+}
@@ -0,0 +1,396 @@
+/* The exact-search engine. This is not an ordinary header: dotsnboxes_variants.h includes it once
+	per solver variant, with a name and one 0/1 macro per policy defined beforehand, e.g.
+
+	#define ENGINE_NAME ab_memo
+	#define ENGINE_AB 1     // alpha-beta window (plus aspiration at the root)
+	#define ENGINE_SYM 0    // skip turns that are mirror images of ones already searched
+	#define ENGINE_MEMO 1   // transposition table keyed by the set of drawn walls
+	#define ENGINE_ORDER 0  // search captures first, then safe turns, then sacrifices
+	#define ENGINE_ROWS 0   // 0 for any board, or the only size the variant handles...
+	#define ENGINE_COLS 0   // ...which must be one of those in gen_tables.c
+	#include "dotsnboxes_engine.h"
+
+	which defines minimax_ab_memo() and solve_ab_memo(). The policies are resolved by the
+	preprocessor, so a variant pays nothing for the ones it leaves out. A fixed-size variant takes
+	everything that depends on the board size from the read-only tables in dotsnboxes_tables.h,
+	so its loops have constant bounds and there are no row/column calculations left. */
+
+#ifndef ENGINE_ROWS
+#define ENGINE_ROWS 0
+#define ENGINE_COLS 0
+#endif
+
+#define ENGINE_PASTE(a, b) a ## _ ## b
+#define ENGINE_EXPAND(a, b) ENGINE_PASTE(a, b)
+#define ENGINE_FN(fn) ENGINE_EXPAND(fn, ENGINE_NAME)
+
+#if ENGINE_ROWS
+#define ENGINE_TABLE_NAME(t, r, c) t ## _ ## r ## x ## c
+#define ENGINE_TABLE_EXPAND(t, r, c) ENGINE_TABLE_NAME(t, r, c)
+#define ENGINE_TABLE(t) ENGINE_TABLE_EXPAND(t, ENGINE_ROWS, ENGINE_COLS)
+#define ENGINE_N_LISTS (ENGINE_ROWS == ENGINE_COLS ? MAX_SYMMETRIES : 4)
+// board i.d. bit of the turn that symmetry s maps 'turn' onto (0 if it maps onto itself)
+#define ENGINE_IMAGE(turn, s) ENGINE_TABLE(wall_images)[s][(turn)->index]
+#define ENGINE_EXECUTE ENGINE_FN(execute_turn)
+#define ENGINE_UNEXECUTE ENGINE_FN(unexecute_turn)
+#define ENGINE_CLOSED_BY ENGINE_FN(boxes_closed_by)
+#define ENGINE_PRIORITY ENGINE_FN(turn_priority)
+#define ENGINE_PLAY_SYMMETRIES ENGINE_FN(play_symmetries)
+#define ENGINE_UNPLAY_SYMMETRIES ENGINE_FN(unplay_symmetries)
+
+/* the board functions of dotsnboxes.h, for this size only */
+DNB_STATIC void ENGINE_FN(execute_turn)(turn_t* turn, board_t* board){
+	const signed char* sq = ENGINE_TABLE(wall_squares)[turn->index];
+	const unsigned char* side = ENGINE_TABLE(wall_sides)[turn->index];
+	board->squares[sq[0]] |= side[0];
+	int closed_boxes = board->squares[sq[0]] == 0xF;
+	if(sq[1] > -1){
+		board->squares[sq[1]] |= side[1];
+		closed_boxes += board->squares[sq[1]] == 0xF;
+	}
+	if(closed_boxes > 0){
+		board->scores[board->player_turn] += closed_boxes;
+	} else{
+		board->player_turn = 1 - board->player_turn;
+	}
+	board->uid |= turn->uid;
+}
+
+DNB_STATIC void ENGINE_FN(unexecute_turn)(turn_t* turn, board_t* board){
+	const signed char* sq = ENGINE_TABLE(wall_squares)[turn->index];
+	const unsigned char* side = ENGINE_TABLE(wall_sides)[turn->index];
+	int opened_boxes = (board->squares[sq[0]] == 0xF) + (sq[1] > -1 && board->squares[sq[1]] == 0xF);
+	board->squares[sq[0]] &= ~side[0];
+	if(sq[1] > -1) board->squares[sq[1]] &= ~side[1];
+	if(opened_boxes > 0){
+		board->scores[board->player_turn] -= opened_boxes;
+	} else{
+		board->player_turn = 1 - board->player_turn;
+	}
+	board->uid &= ~turn->uid;
+}
+
+DNB_STATIC int ENGINE_FN(boxes_closed_by)(turn_t* turn, board_t* board){
+	const signed char* sq = ENGINE_TABLE(wall_squares)[turn->index];
+	const unsigned char* side = ENGINE_TABLE(wall_sides)[turn->index];
+	return ((board->squares[sq[0]] | side[0]) == 0xF) + (sq[1] > -1 && (board->squares[sq[1]] | side[1]) == 0xF);
+}
+
+DNB_STATIC int ENGINE_FN(turn_priority)(turn_t* turn, board_t* board){
+	const signed char* sq = ENGINE_TABLE(wall_squares)[turn->index];
+	int si = count_sides(board->squares[sq[0]]);
+	int sj = sq[1] > -1 ? count_sides(board->squares[sq[1]]) : 0;
+	if(si == 3 || sj == 3) return 2;
+	if(si < 2 && sj < 2) return 1;
+	return 0;
+}
+
+DNB_STATIC void ENGINE_FN(play_symmetries)(turn_t* turn, board_t* board){
+	for(int s=1; s<ENGINE_N_LISTS; ++s){
+		bid_t image = ENGINE_TABLE(wall_images)[s][turn->index];
+		bid_t preimage = ENGINE_TABLE(wall_preimages)[s][turn->index];
+		if(image && !(board->uid & image)) board->asymmetry[s]++;
+		if(preimage && (board->uid & preimage)) board->asymmetry[s]--;
+	}
+}
+
+DNB_STATIC void ENGINE_FN(unplay_symmetries)(turn_t* turn, board_t* board){
+	for(int s=1; s<ENGINE_N_LISTS; ++s){
+		bid_t image = ENGINE_TABLE(wall_images)[s][turn->index];
+		bid_t preimage = ENGINE_TABLE(wall_preimages)[s][turn->index];
+		if(image && !(board->uid & image)) board->asymmetry[s]--;
+		if(preimage && (board->uid & preimage)) board->asymmetry[s]++;
+	}
+}
+#else
+#define ENGINE_N_LISTS board->n_lists
+#define ENGINE_IMAGE(turn, s) ((turn)->pairs[s] != NULL ? (turn)->pairs[s]->uid : 0)
+#define ENGINE_EXECUTE execute_turn
+#define ENGINE_UNEXECUTE unexecute_turn
+#define ENGINE_CLOSED_BY boxes_closed_by
+#define ENGINE_PRIORITY turn_priority
+#define ENGINE_PLAY_SYMMETRIES play_symmetries
+#define ENGINE_UNPLAY_SYMMETRIES unplay_symmetries
+#endif
+
+// charge the hardware counters to the phase the node moves on to (dotsnboxes_perf.h)
+#define ENGINE_PHASE(phase) PERF(perf_phase(&search->perf, phase);)
+// tell the progress reporter, if there is one, about the root (dotsnboxes_progress.h)
+#define ENGINE_ROOT(call) if(depth == 0 && search->progress != NULL) call;
+// a record of the node in the search's trace, if it has one (dotsnboxes_trace.h)
+#define ENGINE_TRACE(kind, index, value, bound) TRACE(if(search->trace != NULL) trace_record(search->trace, kind, depth, \
+	board->uid, index, board->player_turn, value, bound, alpha, beta);)
+
+#if ENGINE_ORDER
+// one pass over the turns per turn_priority(), best first
+#define ENGINE_PASSES 3
+#else
+#define ENGINE_PASSES 1
+#endif
+
+/* at completion, final_value will be the best value for search->maximizer (inside the window
+	(alpha, beta) if it is an alpha-beta variant, otherwise a bound on the side it fell out).
+	returns a pointer to the best move. */
+DNB_STATIC turn_t* ENGINE_FN(minimax)(search_t* search, int* final_value, int depth, int alpha, int beta){
+	board_t* board = search->board;
+	int maximizer = search->maximizer;
+	ENGINE_TRACE(TRACE_NODE, TRACE_NONE, 0, 0)
+	// only one base case: all the way to the end. careful with large boards!
+	if(game_is_over(board)){
+		(*final_value) = board->scores[maximizer] - board->scores[1-maximizer];
+		ENGINE_TRACE(TRACE_RETURN, TRACE_NONE, *final_value, 0)
+		return NULL;
+	}
+	bool max = board->player_turn == maximizer;
+	turn_t* best_turn = board->sentinel;
+	int score, best_score = max ? INT_MIN : INT_MAX;
+	// set once the remaining turns cannot change the result
+	bool cutoff = false;
+#if ENGINE_MEMO
+	int starting_score = board->scores[maximizer] - board->scores[1-maximizer];
+	int alpha_in = alpha, beta_in = beta;
+	// check for memoized solution
+	ENGINE_PHASE(PHASE_PROBE)
+	memo_t* save = read_memo(board);
+	search->memo_probes++;
+	if(save != NULL){
+		search->memo_hits++;
+		ENGINE_TRACE(TRACE_MEMO, save->best_move, save->value, save->bound)
+		// if maximizing, then we _add_ swing value to the starting score.
+		// if minimizing, then we _subtract_ it, which also turns a lower bound into an upper bound
+		int value = max ? starting_score + save->value : starting_score - save->value;
+		int bound = max ? save->bound : flip_bound(save->bound);
+		// a bound is only good enough if it falls outside the current window
+		if(bound == BOUND_EXACT || (bound == BOUND_LOWER && value >= beta) || (bound == BOUND_UPPER && value <= alpha)){
+			(*final_value) = value;
+			ENGINE_TRACE(TRACE_RETURN, save->best_move, value, 0)
+			return board->turns[save->best_move];
+		}
+	}
+#if ENGINE_AB
+	// enhanced transposition cutoff: if the table already has a child that refutes the window,
+	// none of the children need searching. their buckets are all asked for first, so that the
+	// misses overlap instead of one waiting on the other
+	for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next) prefetch_memo(board, board->uid | t->uid);
+	for(turn_t* t = board->sentinel->next; t != board->sentinel && !cutoff; t = t->next){
+		memo_t* child = probe_memo(board, board->uid | t->uid);
+		if(child == NULL) continue;
+		// completing a box keeps the turn and changes the score; otherwise the other player moves
+		int closed = ENGINE_CLOSED_BY(t, board);
+		bool child_max = closed > 0 ? max : !max;
+		int child_score = max ? starting_score + closed : starting_score - closed;
+		int value = child_max ? child_score + child->value : child_score - child->value;
+		int bound = child_max ? child->bound : flip_bound(child->bound);
+		if((max && bound != BOUND_UPPER && value >= beta) || (!max && bound != BOUND_LOWER && value <= alpha)){
+			ENGINE_TRACE(TRACE_ETC, t->index, value, bound)
+			best_turn = t;
+			best_score = value;
+			cutoff = true;
+		}
+	}
+#endif
+#endif
+#if ENGINE_SYM
+	// symmetries of the current position, and the turns already searched from it
+	ENGINE_PHASE(PHASE_SYMMETRY)
+	bool symmetries[MAX_SYMMETRIES];
+	for(int s=1; s<ENGINE_N_LISTS; ++s){
+		symmetries[s] = has_symmetry(board, s);
+	}
+	bid_t searched = 0;
+#endif
+#if ENGINE_AB
+	COUNT(int move_index = 0;)
+#endif
+	ENGINE_ROOT(progress_root(search->progress, board))
+	// loop over all possible turns
+	for(int pass=0; pass<ENGINE_PASSES && !cutoff; ++pass){
+		for(turn_t* current_turn = board->sentinel->next; !cutoff && current_turn != board->sentinel; current_turn = current_turn->next){
+			ENGINE_PHASE(PHASE_MOVEGEN)
+#if ENGINE_ORDER
+			if(ENGINE_PRIORITY(current_turn, board) != ENGINE_PASSES-1 - pass) continue;
+#endif
+#if ENGINE_SYM
+			// check if we can prune this turn based on symmetries: if the position is symmetric
+			// and the mirror image of this turn was already searched, this one scores the same
+			ENGINE_PHASE(PHASE_SYMMETRY)
+			bool current_is_symmetric_to_another_previously_used = false;
+			for(int s=1; s<ENGINE_N_LISTS; ++s){
+				if(symmetries[s] && (searched & ENGINE_IMAGE(current_turn, s))){
+					ENGINE_TRACE(TRACE_SYM, current_turn->index, s, 0)
+					COUNT(search->counters.sym_prunes[s]++;)
+					ENGINE_ROOT(progress_root_pruned(search->progress))
+					current_is_symmetric_to_another_previously_used = true;
+					break;
+				}
+			}
+			// opportunity to prune the rest of this subtree if a symmetry has already been played
+			if(current_is_symmetric_to_another_previously_used) continue;
+#endif
+#if ENGINE_MEMO
+			// the child's first probe, loading while the turn is made
+			prefetch_memo(board, board->uid | current_turn->uid);
+#endif
+			// perform turn, remove it from DLLs
+			ENGINE_PHASE(PHASE_MAKE)
+			ENGINE_EXECUTE(current_turn, board);
+			turn_t* memo = remove_turn_dll(current_turn);
+#if ENGINE_SYM
+			ENGINE_PHASE(PHASE_SYMMETRY)
+			ENGINE_PLAY_SYMMETRIES(current_turn, board);
+#endif
+			ENGINE_PHASE(PHASE_OTHER)
+			// we count all calls of execute_turn for stats on pruning factor
+			search->turn_count++;
+			if(search->turn_count >= search->next_poll) search_poll(search);
+			COUNT(search->counters.nodes[depth+1]++;)
+			ENGINE_TRACE(TRACE_MOVE, current_turn->index, board->scores[maximizer] - board->scores[1-maximizer], 0)
+			// recurse to next level of the tree (without current_turn as an option anymore)
+			ENGINE_FN(minimax)(search, &score, depth+1, alpha, beta);
+			// recursion done; undo move
+#if ENGINE_SYM
+			ENGINE_PHASE(PHASE_SYMMETRY)
+			ENGINE_UNPLAY_SYMMETRIES(current_turn, board);
+			searched |= current_turn->uid;
+#endif
+			ENGINE_PHASE(PHASE_MAKE)
+			add_turn_dll(memo, current_turn);
+			ENGINE_UNEXECUTE(current_turn, board);
+			ENGINE_PHASE(PHASE_OTHER)
+			// out of time or turns: what the subtree returned means nothing, so neither does
+			// anything computed from it. leave without touching the table
+			if(search->aborted){
+				(*final_value) = best_score;
+				return best_turn;
+			}
+			ENGINE_ROOT(progress_root_turn(search->progress, current_turn, score))
+			if(max){
+				// MAX algorithm
+				best_turn = score > best_score ? current_turn : best_turn;
+				best_score = max(best_score, score);
+#if ENGINE_AB
+				alpha = max(alpha, best_score);
+#endif
+			} else{
+				// MIN algorithm
+				best_turn = score < best_score ? current_turn : best_turn;
+				best_score = min(best_score, score);
+#if ENGINE_AB
+				beta = min(beta, best_score);
+#endif
+			}
+#if ENGINE_AB
+			if(beta <= alpha){
+				cutoff = true;
+				ENGINE_TRACE(TRACE_CUTOFF, current_turn->index, best_score, 0)
+				COUNT(search->counters.cutoffs[move_index]++;)
+			}
+			COUNT(move_index++;)
+#endif
+		}
+	}
+	(*final_value) = best_score;
+#if ENGINE_MEMO
+	// how many total points can be gained from here?
+	int swing = max ? best_score - starting_score : starting_score - best_score;
+	// the result is only exact if it landed inside the window we were given (always, without
+	// alpha-beta: the window is wider than any score)
+	int bound = best_score <= alpha_in ? BOUND_UPPER : (best_score >= beta_in ? BOUND_LOWER : BOUND_EXACT);
+	// memoize
+	// an entry found in the table of solved positions is not in the board's, and now will be
+	if(save == NULL || save == &board->solved_hit) search->memo_stored++;
+	ENGINE_PHASE(PHASE_PROBE)
+	write_memo(board, swing, max ? bound : flip_bound(bound), best_turn);
+	COUNT(counters_store(&search->counters, board);)
+	ENGINE_PHASE(PHASE_OTHER)
+#endif
+	ENGINE_TRACE(TRACE_RETURN, best_turn != board->sentinel ? best_turn->index : TRACE_NONE, best_score, 0)
+	return best_turn;
+}
+
+/* leaves of the full game tree 'depth' turns below the position: no pruning, no table, just the
+	turn list and make/unmake, so that solver_perft.c can time those on their own. 'ply' is that of
+	the position's own turns (1 at the top); with 'counts', what the turns at each ply did to the
+	scores and the player to move is added up there too */
+DNB_STATIC long int ENGINE_FN(perft)(board_t* board, int depth, int ply, perft_counts_t* counts){
+	if(depth == 0) return 1;
+	long int leaves = 0;
+	for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next){
+		int player = board->player_turn, score0 = board->scores[0], score1 = board->scores[1];
+		ENGINE_EXECUTE(t, board);
+		if(counts != NULL){
+			counts->captures[ply] += board->scores[0] - score0 + board->scores[1] - score1;
+			counts->player0_captures[ply] += board->scores[0] - score0;
+			counts->extra_turns[ply] += board->player_turn == player;
+		}
+		turn_t* memo = remove_turn_dll(t);
+		leaves += ENGINE_FN(perft)(board, depth-1, ply+1, counts);
+		add_turn_dll(memo, t);
+		ENGINE_UNEXECUTE(t, board);
+	}
+	return leaves;
+}
+
+/* solve the position for the player to move. alpha-beta variants start with an aspiration
+	window around 'guess' and, whenever the value falls outside it, search again with a window on
+	that side that is twice as wide; the others ignore 'guess'. returns null, with no value, if
+	the search hit one of its limits (search_limit()) first */
+DNB_STATIC turn_t* ENGINE_FN(solve)(search_t* search, int guess, int* final_value){
+	board_t* board = search->board;
+	search->maximizer = board->player_turn;
+	// no margin can be larger than the number of boxes, so this is as good as an infinite window
+	int limit = board->rows * board->cols + 1;
+#if ENGINE_MEMO
+	if(board->memo_hashtable == NULL) init_memo(board);
+#endif
+#if ENGINE_AB
+	if(guess >= limit) guess = limit - 1;
+	if(guess <= -limit) guess = 1 - limit;
+	int delta = ASPIRATION_WINDOW;
+	int alpha = guess - delta, beta = guess + delta;
+	while(true){
+		if(alpha < -limit) alpha = -limit;
+		if(beta > limit) beta = limit;
+		if(search->progress != NULL) progress_window(search->progress, alpha, beta);
+		TRACE(if(search->trace != NULL) trace_record(search->trace, TRACE_WINDOW, 0, board->uid, TRACE_NONE, board->player_turn, 0, 0, alpha, beta);)
+		turn_t* best_turn = ENGINE_FN(minimax)(search, final_value, 0, alpha, beta);
+		if(search->aborted) return NULL;
+		if(*final_value <= alpha && alpha > -limit){
+			// failed low: the value is at most final_value
+			beta = *final_value + 1;
+			alpha = *final_value - delta;
+		} else if(*final_value >= beta && beta < limit){
+			// failed high: the value is at least final_value
+			alpha = *final_value - 1;
+			beta = *final_value + delta;
+		} else{
+			return best_turn;
+		}
+		delta *= 2;
+	}
+#else
+	if(search->progress != NULL) progress_window(search->progress, -limit, limit);
+	turn_t* best_turn = ENGINE_FN(minimax)(search, final_value, 0, -limit, limit);
+	return search->aborted ? NULL : best_turn;
+#endif
+}
+
+#undef ENGINE_PASSES
+#undef ENGINE_PHASE
+#undef ENGINE_TRACE
+#undef ENGINE_ROOT
+#undef ENGINE_N_LISTS
+#undef ENGINE_IMAGE
+#undef ENGINE_EXECUTE
+#undef ENGINE_UNEXECUTE
+#undef ENGINE_CLOSED_BY
+#undef ENGINE_PRIORITY
+#undef ENGINE_PLAY_SYMMETRIES
+#undef ENGINE_UNPLAY_SYMMETRIES
+#undef ENGINE_NAME
+#undef ENGINE_AB
+#undef ENGINE_SYM
+#undef ENGINE_MEMO
+#undef ENGINE_ORDER
+#undef ENGINE_ROWS
+#undef ENGINE_COLS
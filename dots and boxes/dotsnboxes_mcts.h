@@ -0,0 +1,531 @@
+#include "dotsnboxes_simd.h"
+#include <math.h>
+
+// UCT exploration constant (rewards are in [0,1])
+#define UCT_C 0.7f
+// progressive widening: a node with n visits has up to 1 + PW_C * sqrt(n) children, made as the
+// visits come in
+#define PW_C 2.0f
+// how often (in iterations) to check the clock
+#define CLOCK_EVERY 64
+
+typedef struct MctsNode{
+	int first_child;  // index into the node pool of the newest child; -1 if none yet
+	int next_sibling; // the parent's next older child; -1 for the oldest
+	int moves;        // index into the move pool of the moves here, best first: the next child is
+	                  // moves[n_children]. -1 until the first child is made
+	short n_children;
+	short n_moves;
+	short move;       // wall index that led here (-1 at the root)
+	// children are made one at a time, but into blocks of slots reserved ahead (as many as there
+	// are children so far), so that mcts_select() mostly reads them one after the other: slots
+	// left in the newest child's block, which come right after it
+	unsigned char block_left;
+	char player;      // player who played 'move'. rewards are stored from their point of view
+	int visits;
+	float reward;
+	float inverse_sqrt; // 1/sqrt(visits), kept up to date on the way back up for mcts_select()
+} mcts_node_t;
+
+/* everything a playout needs, in flat arrays indexed by wall or square */
+typedef struct Playout{
+	int n_walls;
+	int n_squares;
+	short (*wall_squares)[2];  // squares on either side of each wall (-1 off the board)
+	short (*square_walls)[4];  // the four walls of each square
+	turn_t** turns;            // dll node for each wall index
+	// scratch state, rebuilt from the board at the start of every playout
+	unsigned char* sides;
+	unsigned char* drawn;
+	short* order;              // the walls left, in a random order
+	short* later;              // those that were no longer safe when their turn came
+	short* threes;             // stack of squares that reached 3 sides
+	unsigned long long rng;
+} playout_t;
+
+typedef struct Mcts{
+	board_t* board;
+	playout_t playout;
+	mcts_node_t* pool;
+	mcts_node_t* spare;  // as big as the pool: mcts_compact() copies into it and swaps the two
+	int pool_size;
+	int pool_capacity;
+	// the nodes' move lists, likewise
+	short* move_pool;
+	short* move_spare;
+	long int moves_size;
+	long int moves_capacity;
+	int root;
+	// per-move limits
+	long int time_ms;
+	long int memory_bytes;
+	// stats for the last search: leaves played out from, and games played (LANES a leaf on bitboards)
+	long int leaves;
+	long int playouts;
+	double elapsed_ms;
+	// scratch used while walking down the tree
+	turn_t** path_turns;
+	turn_t** path_prevs;
+	int* path_nodes;
+	int* order_prio;
+	// batched bitboard playouts, when the board fits (see dotsnboxes_simd.h)
+	bool bitboard;
+	bitlayout_t layout;
+	uint64_t lane_rng[LANES];
+} mcts_t;
+
+unsigned long long rng_next(unsigned long long* s){
+	// xorshift64*
+	unsigned long long x = *s;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*s = x;
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+void init_playout(playout_t* p, board_t* board, unsigned long long seed){
+	int rows = board->rows, cols = board->cols;
+	p->n_squares = rows * cols;
+	p->n_walls = 2*rows*cols + rows + cols;
+	p->wall_squares = malloc(sizeof(*p->wall_squares) * p->n_walls);
+	p->square_walls = malloc(sizeof(*p->square_walls) * p->n_squares);
+	p->turns = (turn_t**) calloc(p->n_walls, sizeof(turn_t*));
+	p->sides = (unsigned char*) malloc(p->n_squares);
+	p->drawn = (unsigned char*) malloc(p->n_walls);
+	p->order = (short*) malloc(sizeof(short) * p->n_walls);
+	p->later = (short*) malloc(sizeof(short) * p->n_walls);
+	p->threes = (short*) malloc(sizeof(short) * 2 * p->n_walls);
+	p->rng = seed ? seed : 0x9E3779B97F4A7C15ULL;
+
+	for(int w=0; w<p->n_walls; ++w){
+		p->wall_squares[w][0] = -1;
+		p->wall_squares[w][1] = -1;
+	}
+	wall_t types[4] = {TOP, BOTTOM, LEFT, RIGHT};
+	for(int r=0; r<rows; ++r){
+		for(int c=0; c<cols; ++c){
+			int i = r*cols + c;
+			for(int k=0; k<4; ++k){
+				int w = wall_index(r, c, types[k], board);
+				p->square_walls[i][k] = w;
+				// a wall is shared by at most two squares; fill the first free slot
+				if(p->wall_squares[w][0] < 0) p->wall_squares[w][0] = i;
+				else p->wall_squares[w][1] = i;
+			}
+		}
+	}
+	for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next)
+		p->turns[wall_index(t->row, t->col, t->wall, board)] = t;
+}
+
+void free_playout(playout_t* p){
+	free(p->wall_squares);
+	free(p->square_walls);
+	free(p->turns);
+	free(p->sides);
+	free(p->drawn);
+	free(p->order);
+	free(p->later);
+	free(p->threes);
+}
+
+/* a move is safe if it does not put a third side on any square */
+bool playout_is_safe(playout_t* p, int w){
+	int a = p->wall_squares[w][0], b = p->wall_squares[w][1];
+	return p->sides[a] < 2 && (b < 0 || p->sides[b] < 2);
+}
+
+/* uniform random integer in [0, n) */
+int rng_below(unsigned long long* s, int n){
+	return (int)(((rng_next(s) >> 32) * (unsigned long long) n) >> 32);
+}
+
+/* draw wall 'w' in a playout. returns the number of boxes it closed; squares it puts a third
+	side on go on the stack of captures */
+int playout_draw(playout_t* p, int w, int* n_threes){
+	p->drawn[w] = 1;
+	int closed = 0;
+	for(int k=0; k<2; ++k){
+		int sq = p->wall_squares[w][k];
+		if(sq < 0) continue;
+		int sides = ++p->sides[sq];
+		if(sides == 3) p->threes[(*n_threes)++] = sq;
+		closed += sides == 4;
+	}
+	return closed;
+}
+
+/* take every box there is to take, and the ones that taking them opens up */
+void playout_captures(playout_t* p, int* n_threes, int* score){
+	while(*n_threes > 0){
+		int sq = p->threes[--*n_threes];
+		if(p->sides[sq] != 3) continue;
+		for(int k=0; k<4; ++k){
+			int w = p->square_walls[sq][k];
+			if(!p->drawn[w]){
+				*score += playout_draw(p, w, n_threes);
+				break;
+			}
+		}
+	}
+}
+
+/* play random capture-aware moves from the current board to the end of the game: take a free
+	box if there is one, otherwise draw a random wall that puts no third side on a box if there
+	is one, otherwise any random wall. returns the final score difference from player 0's point
+	of view.
+
+	picking at random among the safe walls at every turn is the same as shuffling the walls once
+	and going through them in that order, skipping the ones that are no longer safe: squares only
+	ever gain sides, so a wall that is unsafe once stays unsafe. those wait for the end, when
+	they are all that is left, and are then picked from at random. nothing has to be moved
+	around when a wall turns unsafe, and a safe turn is a couple of lookups. */
+int random_playout(playout_t* p, board_t* board){
+	int n_walls = 0, n_later = 0, n_threes = 0;
+	int scores[2] = {board->scores[0], board->scores[1]};
+	int player = board->player_turn;
+
+	for(int i=0; i<p->n_squares; ++i){
+		// a square is its four wall bits
+		p->sides[i] = __builtin_popcount(board->squares[i]);
+		if(p->sides[i] == 3) p->threes[n_threes++] = i;
+	}
+	memset(p->drawn, 1, p->n_walls);
+	// inside-out shuffle of the walls left
+	for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next){
+		int j = rng_below(&p->rng, n_walls + 1);
+		p->order[n_walls++] = p->order[j];
+		p->order[j] = t->index;
+		p->drawn[t->index] = 0;
+	}
+
+	for(int k=0; k<n_walls; ++k){
+		if(n_threes > 0) playout_captures(p, &n_threes, &scores[player]);
+		int w = p->order[k];
+		if(p->drawn[w]) continue;
+		if(!playout_is_safe(p, w)){
+			p->later[n_later++] = w;
+			continue;
+		}
+		// a safe wall closes nothing
+		playout_draw(p, w, &n_threes);
+		player = 1 - player;
+	}
+	while(true){
+		playout_captures(p, &n_threes, &scores[player]);
+		if(n_later == 0) break;
+		int j = rng_below(&p->rng, n_later);
+		int w = p->later[j];
+		p->later[j] = p->later[--n_later];
+		if(p->drawn[w]) continue;
+		if(playout_draw(p, w, &n_threes) > 0) continue;
+		player = 1 - player;
+	}
+	return scores[0] - scores[1];
+}
+
+void mcts_init(mcts_t* m, board_t* board, long int time_ms, long int memory_bytes, unsigned long long seed){
+	m->board = board;
+	m->time_ms = time_ms;
+	m->memory_bytes = memory_bytes;
+	init_playout(&m->playout, board, seed);
+	// the budget covers the two pools and their spares, half for the nodes and half for the moves
+	int n = m->playout.n_walls + 1;
+	m->pool_capacity = memory_bytes / (4 * sizeof(mcts_node_t));
+	if(m->pool_capacity < 1) m->pool_capacity = 1;
+	m->moves_capacity = memory_bytes / (4 * sizeof(short));
+	if(m->moves_capacity < n) m->moves_capacity = n;
+	m->pool = (mcts_node_t*) malloc(sizeof(mcts_node_t) * m->pool_capacity);
+	m->spare = (mcts_node_t*) malloc(sizeof(mcts_node_t) * m->pool_capacity);
+	m->move_pool = (short*) malloc(sizeof(short) * m->moves_capacity);
+	m->move_spare = (short*) malloc(sizeof(short) * m->moves_capacity);
+	m->moves_size = 0;
+	m->pool_size = 1;
+	m->root = 0;
+	m->pool[0].first_child = -1;
+	m->pool[0].next_sibling = -1;
+	m->pool[0].moves = -1;
+	m->pool[0].n_children = 0;
+	m->pool[0].n_moves = 0;
+	m->pool[0].move = -1;
+	m->pool[0].block_left = 0;
+	m->pool[0].player = 1 - board->player_turn;
+	m->pool[0].visits = 0;
+	m->pool[0].reward = 0;
+	m->pool[0].inverse_sqrt = 0;
+	m->path_turns = (turn_t**) malloc(sizeof(turn_t*) * n);
+	m->path_prevs = (turn_t**) malloc(sizeof(turn_t*) * n);
+	m->path_nodes = (int*) malloc(sizeof(int) * n);
+	m->order_prio = (int*) malloc(sizeof(int) * n);
+	m->leaves = 0;
+	m->playouts = 0;
+	m->elapsed_ms = 0;
+	m->bitboard = bitlayout_init(&m->layout, board->rows, board->cols);
+	seed_lanes(m->lane_rng, m->playout.rng);
+}
+
+void mcts_free(mcts_t* m){
+	// the turns themselves, played or not, are the board's (cleanup())
+	free_playout(&m->playout);
+	free(m->pool);
+	free(m->spare);
+	free(m->move_pool);
+	free(m->move_spare);
+	free(m->path_turns);
+	free(m->path_prevs);
+	free(m->path_nodes);
+	free(m->order_prio);
+}
+
+/* give 'node', whose position is on the board, one more child, so that progressive widening
+	gets to the most promising moves first. the first time, that lists all the node's moves, best
+	priority first and at random among those of the same priority. -1 if either pool is out of
+	memory */
+int mcts_widen(mcts_t* m, int node){
+	board_t* board = m->board;
+	mcts_node_t* parent = &m->pool[node];
+	if(parent->moves < 0){
+		// turn_priority() has three values: count them, then deal the moves out best first, each
+		// one into a random place among those of its priority
+		int count[3] = {0, 0, 0}, n = 0;
+		for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next){
+			m->order_prio[n] = turn_priority(t, board);
+			count[m->order_prio[n++]]++;
+		}
+		if(m->moves_size + n > m->moves_capacity) return -1;
+		short* order = &m->move_pool[m->moves_size];
+		int start[3] = {count[2] + count[1], count[2], 0}, filled[3] = {0, 0, 0};
+		int k = 0;
+		for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next){
+			int pr = m->order_prio[k++];
+			// inside-out shuffle: the new move goes to a random slot and that slot's move to the end
+			int j = rng_below(&m->playout.rng, filled[pr] + 1);
+			order[start[pr] + filled[pr]] = order[start[pr] + j];
+			order[start[pr] + j] = t->index;
+			filled[pr]++;
+		}
+		parent->moves = m->moves_size;
+		parent->n_moves = n;
+		m->moves_size += n;
+	}
+	int k;
+	if(parent->block_left > 0){
+		k = parent->first_child + 1;
+		parent->block_left--;
+	} else{
+		int block = parent->n_children > 2 ? parent->n_children : 2;
+		if(block > parent->n_moves - parent->n_children) block = parent->n_moves - parent->n_children;
+		if(m->pool_size + block > m->pool_capacity) return -1;
+		k = m->pool_size;
+		m->pool_size += block;
+		parent->block_left = block - 1;
+	}
+	mcts_node_t* child = &m->pool[k];
+	child->first_child = -1;
+	child->next_sibling = parent->first_child;
+	child->moves = -1;
+	child->n_children = 0;
+	child->n_moves = 0;
+	child->move = m->move_pool[parent->moves + parent->n_children];
+	child->block_left = 0;
+	child->player = board->player_turn;
+	child->visits = 0;
+	child->reward = 0;
+	child->inverse_sqrt = 0;
+	parent->first_child = k;
+	parent->n_children++;
+	return k;
+}
+
+/* the child to go down to: a new one if progressive widening allows one more, otherwise the best by
+	UCT. -1 if there is none (no memory for the first) */
+int mcts_select(mcts_t* m, int node){
+	mcts_node_t* parent = &m->pool[node];
+	int allowed = 1 + (int)(PW_C * sqrtf((float) parent->visits));
+	if(parent->n_children < allowed && (parent->moves < 0 || parent->n_children < parent->n_moves)){
+		int child = mcts_widen(m, node);
+		if(child >= 0) return child;
+	}
+	// the exploration term is UCT_C * sqrt(log(n) / visits), the same numerator for every child:
+	// with the children's 1/sqrt(visits) at hand, scoring one takes no division or square root
+	float explore = UCT_C * sqrtf(logf((float) parent->visits + 1));
+	int best = -1;
+	float best_uct = -1;
+	for(int c = parent->first_child; c >= 0; c = m->pool[c].next_sibling){
+		mcts_node_t* child = &m->pool[c];
+		if(child->visits == 0) return c;
+		float uct = (child->reward * child->inverse_sqrt + explore) * child->inverse_sqrt;
+		if(uct > best_uct){
+			best_uct = uct;
+			best = c;
+		}
+	}
+	return best;
+}
+
+/* one iteration: walk down with UCT, adding a child where progressive widening allows, play out,
+	back up */
+void mcts_iterate(mcts_t* m){
+	board_t* board = m->board;
+	int depth = 0;
+	int node = m->root;
+	m->path_nodes[depth] = node;
+	while(!game_is_over(board)){
+		// a new leaf just gets a playout; its children come from its later visits
+		if(m->pool[node].visits == 0 && node != m->root) break;
+		int child = mcts_select(m, node);
+		if(child < 0) break;
+		node = child;
+		turn_t* t = m->playout.turns[m->pool[node].move];
+		execute_turn(t, board);
+		m->path_prevs[depth] = remove_turn_dll(t);
+		m->path_turns[depth] = t;
+		m->path_nodes[++depth] = node;
+	}
+	// play out from the leaf: LANES games at once on bitboards, or one game on the dll board
+	int n_games = 1;
+	float reward_0 = 0;
+	if(m->bitboard){
+		bitgame_t games[LANES];
+		int margins[LANES];
+		board_to_bitgame(board, &m->layout, &games[0]);
+		for(int l=1; l<LANES; ++l) games[l] = games[0];
+		bit_playout_lanes(&m->layout, games, margins, m->lane_rng);
+		n_games = LANES;
+		for(int l=0; l<LANES; ++l)
+			reward_0 += margins[l] > 0 ? 1.0f : (margins[l] == 0 ? 0.5f : 0.0f);
+	} else{
+		int margin = random_playout(&m->playout, board);
+		reward_0 = margin > 0 ? 1.0f : (margin == 0 ? 0.5f : 0.0f);
+	}
+	m->leaves++;
+	m->playouts += n_games;
+	// back up; each node holds the reward for the player who moved into it
+	for(int d=depth; d>=0; --d){
+		mcts_node_t* n = &m->pool[m->path_nodes[d]];
+		n->visits += n_games;
+		n->reward += n->player == 0 ? reward_0 : n_games - reward_0;
+		n->inverse_sqrt = 1.0f / sqrtf((float) n->visits);
+	}
+	// undo the moves made on the way down
+	for(int d=depth-1; d>=0; --d){
+		add_turn_dll(m->path_prevs[d], m->path_turns[d]);
+		unexecute_turn(m->path_turns[d], board);
+	}
+}
+
+/* search from the current board until the per-move time limit runs out.
+	returns the wall index of the most visited root move */
+int mcts_search(mcts_t* m){
+	double start = now_ms();
+	long int leaves_before = m->leaves, before = m->playouts;
+	for(long int it=0; ; ++it){
+		if(it % CLOCK_EVERY == 0 && now_ms() - start >= m->time_ms) break;
+		mcts_iterate(m);
+	}
+	m->elapsed_ms = now_ms() - start;
+	m->leaves -= leaves_before;
+	m->playouts -= before;
+
+	mcts_node_t* root = &m->pool[m->root];
+	int best = -1, best_visits = -1;
+	for(int c = root->first_child; c >= 0; c = m->pool[c].next_sibling){
+		mcts_node_t* child = &m->pool[c];
+		if(child->visits > best_visits){
+			best_visits = child->visits;
+			best = child->move;
+		}
+	}
+	if(best < 0){
+		// no time for even one child: fall back to the first legal move
+		turn_t* t = m->board->sentinel->next;
+		best = wall_index(t->row, t->col, t->wall, m->board);
+	}
+	return best;
+}
+
+/* copy the subtree under 'node' to the front of the pool so that it can be reused as the new
+	root. a breadth-first copy into the spare pool puts each node's children next to each other,
+	and they are linked again in that order; the move lists go along into the spare move pool.
+	then the pools and their spares trade places. */
+void mcts_compact(mcts_t* m, int node){
+	mcts_node_t* copy = m->spare;
+	int size = 1, head = 0;
+	long int moves = 0;
+	copy[0] = m->pool[node];
+	copy[0].next_sibling = -1;
+	while(head < size){
+		mcts_node_t* n = &copy[head++];
+		if(n->moves >= 0){
+			memcpy(&m->move_spare[moves], &m->move_pool[n->moves], sizeof(short) * n->n_moves);
+			n->moves = moves;
+			moves += n->n_moves;
+		}
+		int from = n->first_child;
+		if(from < 0) continue;
+		n->first_child = size;
+		// the slots reserved but not used yet are left behind
+		n->block_left = 0;
+		for(int c = from; c >= 0; c = m->pool[c].next_sibling){
+			copy[size] = m->pool[c];
+			copy[size].next_sibling = m->pool[c].next_sibling >= 0 ? size + 1 : -1;
+			size++;
+		}
+	}
+	m->spare = m->pool;
+	m->pool = copy;
+	m->pool_size = size;
+	short* move_copy = m->move_spare;
+	m->move_spare = m->move_pool;
+	m->move_pool = move_copy;
+	m->moves_size = moves;
+	m->root = 0;
+}
+
+/* play wall 'w' on the board and move the root down to it, keeping its subtree */
+void mcts_advance(mcts_t* m, int w){
+	turn_t* t = m->playout.turns[w];
+	execute_turn(t, m->board);
+	remove_turn_dll(t);
+	mcts_node_t* root = &m->pool[m->root];
+	int next = -1;
+	for(int c = root->first_child; c >= 0; c = m->pool[c].next_sibling){
+		if(m->pool[c].move == w){
+			next = c;
+			break;
+		}
+	}
+	if(next >= 0){
+		mcts_compact(m, next);
+	} else{
+		m->pool_size = 1;
+		m->moves_size = 0;
+		m->root = 0;
+		m->pool[0].first_child = -1;
+		m->pool[0].next_sibling = -1;
+		m->pool[0].moves = -1;
+		m->pool[0].n_children = 0;
+		m->pool[0].n_moves = 0;
+		m->pool[0].move = w;
+		m->pool[0].block_left = 0;
+		m->pool[0].visits = 0;
+		m->pool[0].reward = 0;
+		m->pool[0].inverse_sqrt = 0;
+	}
+	m->pool[m->root].player = 1 - m->board->player_turn;
+}
+
+/* printout for a single move */
+void mcts_stats(mcts_t* m, int player, int w){
+	turn_t* t = m->playout.turns[w];
+	mcts_node_t* root = &m->pool[m->root];
+	double win_rate = 0;
+	for(int c = root->first_child; c >= 0; c = m->pool[c].next_sibling){
+		mcts_node_t* child = &m->pool[c];
+		if(child->move == w && child->visits > 0) win_rate = child->reward / child->visits;
+	}
+	double ms = m->elapsed_ms > 0 ? m->elapsed_ms : 1;
+	printf("player %d: %d %d %s (%ld leaves, %.0f/ms, %ld playouts, %.0f/ms, %.2f expected, %d nodes)\n", player, t->row,
+		t->col, wall_name(t->wall), m->leaves, m->leaves / ms, m->playouts, m->playouts / ms, win_rate, m->pool_size);
+}
@@ -0,0 +1,216 @@
+/* Hardware counters by search phase, for tuning the engine's hot path. Like the counters of
+	dotsnboxes_counters.h they only exist when built with -DPERF_COUNTERS ("make perf"): otherwise
+	PERF(...) drops its argument and the engine is untouched.
+
+	The engine calls perf_phase() whenever it moves from one phase of a node to another, and
+	whatever the counters advanced by since the previous call is charged to the phase it is
+	leaving, so the phases always add up to the whole solve. The counters are read with rdpmc where
+	the kernel allows it, which costs tens of cycles; otherwise with one read() of the group, which
+	costs a system call. Either way the phases include a little of their own measuring, and the
+	solve runs slower than it would without, so time a plain build for absolute numbers.
+	If perf_event_open() is not allowed (see /proc/sys/kernel/perf_event_paranoid) or the machine
+	has no such counters, the search runs as usual and the breakdown says why it is missing. */
+
+#ifdef PERF_COUNTERS
+#define PERF(...) __VA_ARGS__
+#else
+#define PERF(...)
+#endif
+
+enum Phase{
+	PHASE_MOVEGEN,  // walking the turn list, priority filter of move ordering
+	PHASE_MAKE,     // execute/unexecute and the turn list updates
+	PHASE_PROBE,    // transposition table reads and writes (including ETC)
+	PHASE_SYMMETRY, // symmetry tests, pruning and bookkeeping
+	PHASE_OTHER,    // everything else: scores, window updates, leaves, calls
+	N_PHASES
+};
+
+enum Event{
+	EVENT_CYCLES,
+	EVENT_INSTRUCTIONS,
+	EVENT_CACHE_MISSES,
+	EVENT_BRANCH_MISSES,
+	N_EVENTS
+};
+
+#ifdef PERF_COUNTERS
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+DNB_STATIC const char* phase_names[N_PHASES] = {"movegen", "make", "probe", "symmetry", "other"};
+DNB_STATIC const char* event_names[N_EVENTS] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+DNB_STATIC const unsigned long long event_configs[N_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+typedef struct Perf{
+	int fd[N_EVENTS];       // -1 once closed, or if never opened
+	bool have[N_EVENTS];    // events the machine has; none if unavailable
+	struct perf_event_mmap_page* page[N_EVENTS]; // for rdpmc, or null
+	bool rdpmc;             // all open events can be read from user space
+	const char* error;      // why there are no counters, or null
+	int phase;              // the phase being charged
+	uint64_t last[N_EVENTS]; // counter values at the last phase switch
+	uint64_t counts[N_PHASES][N_EVENTS];
+	long int switches[N_PHASES]; // times each phase was entered
+} perf_t;
+
+#if defined(__x86_64__) || defined(__i386__)
+DNB_STATIC uint64_t perf_rdpmc(struct perf_event_mmap_page* page){
+	uint32_t seq;
+	uint64_t count;
+	do{
+		seq = page->lock;
+		__asm__ volatile("" ::: "memory");
+		uint32_t index = page->index;
+		count = page->offset;
+		// index 0: not on a hardware counter right now, the offset is all there is
+		if(index){
+			uint32_t lo, hi;
+			__asm__ volatile("rdpmc" : "=a"(lo), "=d"(hi) : "c"(index - 1));
+			int64_t pmc = (int64_t) (((uint64_t) hi << 32) | lo);
+			// sign-extend from the counter width
+			pmc <<= 64 - page->pmc_width;
+			pmc >>= 64 - page->pmc_width;
+			count += pmc;
+		}
+		__asm__ volatile("" ::: "memory");
+	} while(page->lock != seq);
+	return count;
+}
+#endif
+
+/* current value of every open event */
+DNB_STATIC void perf_read(perf_t* p, uint64_t* values){
+#if defined(__x86_64__) || defined(__i386__)
+	if(p->rdpmc){
+		for(int e=0; e<N_EVENTS; ++e)
+			values[e] = p->have[e] ? perf_rdpmc(p->page[e]) : 0;
+		return;
+	}
+#endif
+	// PERF_FORMAT_GROUP: the number of events, then their values in the order they were opened
+	uint64_t group[1 + N_EVENTS];
+	if(read(p->fd[EVENT_CYCLES], group, sizeof(group)) < 0) return;
+	int k = 1;
+	for(int e=0; e<N_EVENTS; ++e)
+		values[e] = p->have[e] ? group[k++] : 0;
+}
+
+/* open the counters for this thread. never fails: without them, p->error says why */
+DNB_STATIC void perf_open(perf_t* p){
+	memset(p, 0, sizeof(perf_t));
+	p->phase = PHASE_OTHER;
+	for(int e=0; e<N_EVENTS; ++e){
+		p->fd[e] = -1;
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = event_configs[e];
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP;
+		// cycles leads the group, so that all of them are scheduled together
+		attr.disabled = e == EVENT_CYCLES;
+		int leader = e == EVENT_CYCLES ? -1 : p->fd[EVENT_CYCLES];
+		p->fd[e] = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+		p->have[e] = p->fd[e] >= 0;
+		if(!p->have[e] && e == EVENT_CYCLES){
+			p->error = errno == EACCES || errno == EPERM ? "not permitted (perf_event_paranoid)" :
+				(errno == ENOENT || errno == ENODEV || errno == EOPNOTSUPP ? "no hardware counters" : strerror(errno));
+			return;
+		}
+	}
+	p->rdpmc = true;
+	long int page_size = sysconf(_SC_PAGESIZE);
+	for(int e=0; e<N_EVENTS; ++e){
+		if(!p->have[e]) continue;
+		void* page = mmap(NULL, page_size, PROT_READ, MAP_SHARED, p->fd[e], 0);
+		p->page[e] = page == MAP_FAILED ? NULL : (struct perf_event_mmap_page*) page;
+		if(p->page[e] == NULL || !p->page[e]->cap_user_rdpmc) p->rdpmc = false;
+	}
+	ioctl(p->fd[EVENT_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	perf_read(p, p->last);
+}
+
+/* the counts stay, for printing */
+DNB_STATIC void perf_close(perf_t* p){
+	long int page_size = sysconf(_SC_PAGESIZE);
+	for(int e=N_EVENTS-1; e>=0; --e){
+		if(p->page[e] != NULL) munmap(p->page[e], page_size);
+		if(p->fd[e] >= 0) close(p->fd[e]);
+		p->fd[e] = -1;
+		p->page[e] = NULL;
+	}
+}
+
+/* charge what happened since the last switch to the current phase, and move to 'phase' */
+DNB_STATIC void perf_phase(perf_t* p, int phase){
+	if(!p->have[EVENT_CYCLES]) return;
+	uint64_t now[N_EVENTS];
+	perf_read(p, now);
+	for(int e=0; e<N_EVENTS; ++e){
+		p->counts[p->phase][e] += now[e] - p->last[e];
+		p->last[e] = now[e];
+	}
+	p->phase = phase;
+	p->switches[phase]++;
+}
+
+DNB_STATIC uint64_t perf_total(perf_t* p, int event){
+	uint64_t total = 0;
+	for(int ph=0; ph<N_PHASES; ++ph) total += p->counts[ph][event];
+	return total;
+}
+
+/* printouts after stats() */
+DNB_STATIC void print_perf(perf_t* p){
+	if(!p->have[EVENT_CYCLES]){
+		printf("perf counters unavailable: %s\n", p->error);
+		return;
+	}
+	uint64_t cycles = perf_total(p, EVENT_CYCLES);
+	printf("%-9s %12s %14s %14s %6s %12s %12s %6s\n", "phase", "entered", "cycles", "instructions", "ipc",
+		"cache_miss", "branch_miss", "cyc%");
+	for(int ph=0; ph<N_PHASES; ++ph){
+		uint64_t* c = p->counts[ph];
+		printf("%-9s %12ld %14llu %14llu %6.2f ", phase_names[ph], p->switches[ph], (unsigned long long) c[EVENT_CYCLES],
+			(unsigned long long) c[EVENT_INSTRUCTIONS], c[EVENT_CYCLES] ? (double) c[EVENT_INSTRUCTIONS] / c[EVENT_CYCLES] : 0.0);
+		for(int e=EVENT_CACHE_MISSES; e<N_EVENTS; ++e){
+			if(!p->have[e]) printf("%12s ", "n/a");
+			else printf("%12llu ", (unsigned long long) c[e]);
+		}
+		printf("%5.1f%%\n", cycles ? 100.0 * c[EVENT_CYCLES] / cycles : 0.0);
+	}
+	printf("(read with %s)\n", p->rdpmc ? "rdpmc" : "read()");
+}
+
+/* the same numbers as extra csv columns, "<phase>_<event>", for solver_bench */
+DNB_STATIC void perf_csv_header(){
+	for(int ph=0; ph<N_PHASES; ++ph)
+		for(int e=0; e<N_EVENTS; ++e) printf(",%s_%s", phase_names[ph], event_names[e]);
+}
+
+/* unavailable events are left empty */
+DNB_STATIC void perf_csv_values(perf_t* p){
+	for(int ph=0; ph<N_PHASES; ++ph)
+		for(int e=0; e<N_EVENTS; ++e){
+			if(!p->have[e]) printf(",");
+			else printf(",%llu", (unsigned long long) p->counts[ph][e]);
+		}
+}
+
+/* ...and json members, with null for unavailable events */
+DNB_STATIC void perf_json_values(perf_t* p){
+	for(int ph=0; ph<N_PHASES; ++ph)
+		for(int e=0; e<N_EVENTS; ++e){
+			if(!p->have[e]) printf(", \"%s_%s\": null", phase_names[ph], event_names[e]);
+			else printf(", \"%s_%s\": %llu", phase_names[ph], event_names[e], (unsigned long long) p->counts[ph][e]);
+		}
+}
+#endif
@@ -0,0 +1,298 @@
+#include "dotsnboxes.h"
+#include "dotsnboxes_tables.h"
+
+/* Depth-first proof-number search (df-pn). Instead of the exact score it answers a yes/no
+	question, "does player 0 finish more than 'target' boxes ahead?", by expanding whichever
+	part of the tree looks cheapest to prove or disprove. Asking it twice (target 0 and -1)
+	gives the win/draw/lose outcome that stats() prints.
+	what is left of a game only depends on the walls, so the table is keyed on them alone and
+	asks the question of the player to move, about the boxes still to come: "do they net more
+	than 'target' of them?". positions that only differ in the score or whose turn it is share
+	their entries that way, and so do the two questions (a proof for one target is one for every
+	lower target, a disproof one for every higher). the key is also the same for all of the
+	position's symmetric images. */
+
+// proof/disproof table will have 2^bitwidth buckets of two entries
+#define PNS_TABLE_BITWIDTH 20
+#define PN_INF 100000000
+
+typedef struct PnsEntry{
+	uint64_t key; // of the walls
+	int pn;
+	int dn;
+	int target; // of the player to move, over the boxes still to come
+	unsigned int work; // mid() calls spent below it, which decides what stays in the bucket
+} pns_entry_t;
+
+typedef struct Pns{
+	board_t* board;
+	int target;
+	int n_walls;
+	int n_squares;
+	uint64_t key;       // the smallest of keys[]
+	uint64_t keys[MAX_SYMMETRIES];  // zobrist hash of the images of the drawn walls, per symmetry
+	const uint64_t* zobrist;  // per wall
+	uint64_t* zobrist_alloc;  // the same, when the board size has no generated table
+	pns_entry_t* table;
+	long int nodes;     // number of mid() calls
+} pns_t;
+
+/* draw or undraw the wall of 't' in the keys */
+void pns_toggle(pns_t* p, turn_t* t){
+	p->keys[0] ^= p->zobrist[t->index];
+	p->key = p->keys[0];
+	for(int s=1; s<p->board->n_lists; ++s){
+		p->keys[s] ^= p->zobrist[t->pairs[s] != NULL ? t->pairs[s]->index : t->index];
+		if(p->keys[s] < p->key) p->key = p->keys[s];
+	}
+}
+
+void pns_init(pns_t* p, board_t* board){
+	p->board = board;
+	p->n_walls = 2*board->rows*board->cols + board->rows + board->cols;
+	p->n_squares = board->rows * board->cols;
+	// listed sizes have the wall keys in read-only tables (the same numbers as drawn here)
+	p->zobrist = kernel_zobrist(board->rows, board->cols);
+	p->zobrist_alloc = p->zobrist == NULL ? (uint64_t*) malloc(sizeof(uint64_t) * p->n_walls) : NULL;
+	uint64_t seed = 42;
+	for(int w=0; w<p->n_walls; ++w){
+		uint64_t z = splitmix64(&seed);
+		if(p->zobrist_alloc != NULL) p->zobrist_alloc[w] = z;
+	}
+	if(p->zobrist_alloc != NULL) p->zobrist = p->zobrist_alloc;
+	memset(p->keys, 0, sizeof(p->keys));
+	p->key = 0;
+	// the board may already have walls on it
+	for(int r=0; r<board->rows; ++r){
+		for(int c=0; c<board->cols; ++c){
+			square_t sq = board->squares[r*board->cols + c];
+			// count each wall once: top and left always, bottom/right only on the last row/column
+			if(sq & TOP) pns_toggle(p, board->turns[wall_index(r, c, TOP, board)]);
+			if(sq & LEFT) pns_toggle(p, board->turns[wall_index(r, c, LEFT, board)]);
+			if(r == board->rows-1 && (sq & BOTTOM)) pns_toggle(p, board->turns[wall_index(r, c, BOTTOM, board)]);
+			if(c == board->cols-1 && (sq & RIGHT)) pns_toggle(p, board->turns[wall_index(r, c, RIGHT, board)]);
+		}
+	}
+	p->table = (pns_entry_t*) calloc((size_t)2 << PNS_TABLE_BITWIDTH, sizeof(pns_entry_t));
+	p->nodes = 0;
+}
+
+void pns_free(pns_t* p){
+	free(p->zobrist_alloc);
+	free(p->table);
+}
+
+/* the bucket of the current walls */
+pns_entry_t* pns_bucket(pns_t* p){
+	return &p->table[(p->key & (((uint64_t)1 << PNS_TABLE_BITWIDTH) - 1)) * 2];
+}
+
+/* player 0's question as one about the boxes still to come, asked of the player to move: "do
+	they net more than the result?". when that is player 1, a yes to it is a no to player 0's,
+	so 'swap' is set and their proof and disproof numbers trade places */
+int pns_target(pns_t* p, bool* swap){
+	board_t* board = p->board;
+	int diff = board->scores[0] - board->scores[1];
+	*swap = board->player_turn == 1;
+	// player 0 nets more than target - diff, i.e. player 1 nets at most diff - target - 1
+	return *swap ? diff - p->target - 1 : p->target - diff;
+}
+
+/* proof and disproof numbers of the current position: from the score, from the table, or a guess */
+void pns_lookup(pns_t* p, int* pn, int* dn){
+	board_t* board = p->board;
+	int remaining = p->n_squares - board->scores[0] - board->scores[1];
+	bool swap;
+	int target = pns_target(p, &swap);
+	// proven: more than target even if the rest all go the other way. disproven: not even
+	// with all of them. in between, a position not searched yet looks the easier to prove the
+	// fewer boxes it would take to prove it, and the same for disproving
+	int mover_pn = 1 + target + remaining, mover_dn = remaining - target;
+	if(-remaining > target){
+		mover_pn = 0;
+		mover_dn = PN_INF;
+	} else if(remaining <= target){
+		mover_pn = PN_INF;
+		mover_dn = 0;
+	} else{
+		pns_entry_t* e = pns_bucket(p);
+		for(int w=0; w<2; ++w, ++e){
+			if(e->key != p->key || (e->pn == 0 && e->dn == 0)) continue;
+			if(e->target == target || (e->pn == 0 && target < e->target) || (e->dn == 0 && target > e->target)){
+				mover_pn = e->pn;
+				mover_dn = e->dn;
+				break;
+			}
+		}
+	}
+	*pn = swap ? mover_dn : mover_pn;
+	*dn = swap ? mover_pn : mover_dn;
+}
+
+/* keeps the entry with the most work behind it first in the bucket, and the latest one of the
+	rest second, so that big subtrees are not thrown away for the many small ones near the
+	leaves */
+void pns_store(pns_t* p, int pn, int dn, unsigned int work){
+	bool swap;
+	int target = pns_target(p, &swap);
+	pns_entry_t entry = {p->key, swap ? dn : pn, swap ? pn : dn, target, work};
+	pns_entry_t* bucket = pns_bucket(p);
+	for(int w=0; w<2; ++w){
+		if(bucket[w].key == p->key && bucket[w].target == target){
+			entry.work += bucket[w].work;
+			bucket[w] = entry;
+			if(w == 1 && entry.work >= bucket[0].work){
+				bucket[w] = bucket[0];
+				bucket[0] = entry;
+			}
+			return;
+		}
+	}
+	if(entry.work >= bucket[0].work){
+		bucket[1] = bucket[0];
+		bucket[0] = entry;
+	} else{
+		bucket[1] = entry;
+	}
+}
+
+void pns_execute(pns_t* p, turn_t* t){
+	execute_turn(t, p->board);
+	pns_toggle(p, t);
+}
+
+void pns_unexecute(pns_t* p, turn_t* t){
+	unexecute_turn(t, p->board);
+	pns_toggle(p, t);
+}
+
+/* whether 't' completes a box without putting a third side on another one. taking such a box
+	is never worse than any other turn, since leaving it for later cannot gain anything, so a
+	node that has one only needs that child */
+bool pns_free_capture(turn_t* t, board_t* board){
+	int j = opposite(t->row, t->col, t->wall, board);
+	int si = count_sides(board->squares[t->row*board->cols + t->col]);
+	int sj = j > -1 ? count_sides(board->squares[j]) : 0;
+	return (si == 3 && sj != 2) || (sj == 3 && si != 2);
+}
+
+int sum_capped(int a, int b){
+	return a + b >= PN_INF ? PN_INF : a + b;
+}
+
+/* multiple iterative deepening: search below the current position until its proof number reaches
+	th_pn or its disproof number reaches th_dn, and leave them in 'pn' and 'dn'. returns the
+	most promising turn at the end (once solved, one that is solved the same way), or NULL if
+	the position needed no search */
+turn_t* mid(pns_t* p, int th_pn, int th_dn, int* pn, int* dn){
+	board_t* board = p->board;
+	long int start = p->nodes++;
+	pns_lookup(p, pn, dn);
+	if(*pn >= th_pn || *dn >= th_dn || *pn == 0 || *dn == 0) return NULL;
+
+	// player 0 is trying to prove, so their nodes are OR nodes
+	bool or_node = board->player_turn == 0;
+	turn_t* children[p->n_walls];
+	int child_pn[p->n_walls], child_dn[p->n_walls];
+	uint64_t child_key[p->n_walls];
+	// with a free capture, that is the only child worth searching
+	turn_t* capture = NULL;
+	for(turn_t* t = board->sentinel->next; t != board->sentinel && capture == NULL; t = t->next)
+		if(pns_free_capture(t, board)) capture = t;
+	// proof numbers of the children, from the table at first and then from what searching them
+	// returned: a table entry can be gone by the time it is looked for again (two children in
+	// one bucket would push each other out and the search go round in circles)
+	int n = 0;
+	for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next){
+		if(capture != NULL && t != capture) continue;
+		pns_execute(p, t);
+		child_key[n] = p->key;
+		pns_lookup(p, &child_pn[n], &child_dn[n]);
+		pns_unexecute(p, t);
+		// one of the turns that lead to symmetric images of a position is enough
+		bool image = false;
+		for(int k=0; k<n && !image; ++k) image = child_key[k] == child_key[n];
+		if(!image) children[n++] = t;
+	}
+	int best;
+	while(true){
+		int second = PN_INF, sum = 0, minimum = PN_INF;
+		best = -1;
+		for(int k=0; k<n; ++k){
+			// 'small' is the number this node minimises over its children, 'large' the one it sums
+			int small = or_node ? child_pn[k] : child_dn[k];
+			int large = or_node ? child_dn[k] : child_pn[k];
+			sum = sum_capped(sum, large);
+			if(best < 0 || small < minimum){
+				second = minimum;
+				minimum = small;
+				best = k;
+			} else if(small < second){
+				second = small;
+			}
+		}
+		*pn = or_node ? minimum : sum;
+		*dn = or_node ? sum : minimum;
+		if(*pn >= th_pn || *dn >= th_dn) break;
+
+		// descend into the most promising child with thresholds that make it return as soon as
+		// another child would become the most promising
+		int th_small = or_node ? th_pn : th_dn;
+		int th_large = or_node ? th_dn : th_pn;
+		// (with some slack over the second best, so that two close children do not take turns
+		// a node at a time: the 1+epsilon trick)
+		long int slack = second + second / 4 + 1;
+		int small_child = slack < th_small ? (int) slack : th_small;
+		int large_child = th_large - sum + (or_node ? child_dn[best] : child_pn[best]);
+		if(large_child > PN_INF) large_child = PN_INF;
+		turn_t* t = children[best];
+		pns_execute(p, t);
+		turn_t* memo = remove_turn_dll(t);
+		if(or_node) mid(p, small_child, large_child, &child_pn[best], &child_dn[best]);
+		else mid(p, large_child, small_child, &child_pn[best], &child_dn[best]);
+		add_turn_dll(memo, t);
+		pns_unexecute(p, t);
+	}
+	pns_store(p, *pn, *dn, (unsigned int) (p->nodes - start));
+	return children[best];
+}
+
+/* true if player 0 can finish more than 'target' ahead. 'proof' gets a root move that leads to
+	the same answer (NULL once the game is over) */
+bool prove(pns_t* p, int target, turn_t** proof){
+	// the table stays: its entries hold for any target
+	p->target = target;
+	int pn, dn;
+	do *proof = mid(p, PN_INF, PN_INF, &pn, &dn);
+	while(pn != 0 && dn != 0);
+	if(*proof != NULL) return pn == 0;
+	// solved before searching: pick a root move that the table has solved the same way as the
+	// root. when every move is, any will do
+	board_t* board = p->board;
+	*proof = game_is_over(board) ? NULL : board->sentinel->next;
+	for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next){
+		int cpn, cdn;
+		pns_execute(p, t);
+		pns_lookup(p, &cpn, &cdn);
+		pns_unexecute(p, t);
+		if((pn == 0 ? cpn : cdn) == 0){
+			*proof = t;
+			break;
+		}
+	}
+	return pn == 0;
+}
+
+/* printouts at end, matching the first lines of stats() */
+void pns_stats(board_t* board, int outcome, turn_t* best_turn, long int nodes){
+	if(outcome > 0)
+		printf("win\n");
+	else if(outcome < 0)
+		printf("lose\n");
+	else
+		printf("draw\n");
+
+	if(best_turn != NULL) printf("best option: %d %d %s\n", best_turn->row, best_turn->col, wall_name(best_turn->wall));
+	printf("%d walls\n", n_walls(board));
+	printf("%ld nodes\n", nodes);
+}
@@ -0,0 +1,214 @@
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/* Live progress of a long solve, from a thread of its own. The search only touches it at the
+	root (a new aspiration window, a root turn finished or pruned); everything else, including the
+	turn count and the table fill, the reporter reads straight out of search_t while the search
+	runs. Those reads race with the search's writes, harmlessly: a report may be a node or so out
+	of date, and the search never waits for one.
+
+	Off unless the environment asks for it:
+		DNB_PROGRESS=s      a line on stderr every s seconds (default 1 if either of the others is set)
+		DNB_STATUS=file     the same as a json object, rewritten (atomically) every s seconds
+		DNB_SOCKET=path     a unix stream socket that sends that json to whoever connects, e.g.
+		                    "socat - UNIX-CONNECT:path" or "nc -U path"
+	The ETA assumes the root turns still to come take as long as the finished ones did on average,
+	which the first root turn (the only one searched with a full window) makes pessimistic. */
+
+typedef struct Progress{
+	search_t* search;
+	const char* name;
+	double start_ms;
+	double interval_ms;
+	const char* status_path;
+	const char* socket_path;
+	int listen_fd; // -1 without a socket
+	pthread_t thread;
+	volatile bool stop;
+	// written by the search, at the root only
+	volatile int passes; // aspiration windows tried
+	volatile int alpha, beta;
+	volatile double pass_ms; // when the current window started
+	volatile int root_total, root_done, root_pruned;
+	volatile int root_turn[MAX_UID_WALLS]; // wall index of each searched root turn, in order
+	volatile int root_value[MAX_UID_WALLS];
+} progress_t;
+
+/* the search's side */
+
+DNB_STATIC void progress_window(progress_t* p, int alpha, int beta){
+	p->alpha = alpha;
+	p->beta = beta;
+	p->pass_ms = now_ms();
+	p->root_done = 0;
+	p->root_pruned = 0;
+	p->passes++;
+}
+
+DNB_STATIC void progress_root(progress_t* p, board_t* board){
+	int n = 0;
+	for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next) ++n;
+	p->root_total = n;
+}
+
+DNB_STATIC void progress_root_turn(progress_t* p, turn_t* turn, int value){
+	int k = p->root_done - p->root_pruned;
+	p->root_turn[k] = turn->index;
+	p->root_value[k] = value;
+	p->root_done++;
+}
+
+DNB_STATIC void progress_root_pruned(progress_t* p){
+	p->root_pruned++;
+	p->root_done++;
+}
+
+/* the reporter's side */
+
+/* seconds left, or -1 before the first root turn is done */
+DNB_STATIC double progress_eta(progress_t* p, double now){
+	int done = p->root_done, total = p->root_total;
+	if(done == 0 || total == 0) return -1;
+	return (now - p->pass_ms) / 1e3 * (total - done) / done;
+}
+
+/* the status as json, into buf */
+DNB_STATIC int progress_json(progress_t* p, char* buf, int size, bool finished, int value){
+	search_t* s = p->search;
+	board_t* board = s->board;
+	double now = now_ms();
+	double elapsed = (now - p->start_ms) / 1e3;
+	long int turns = s->turn_count;
+	long int stored = s->memo_stored;
+	int n = snprintf(buf, size, "{\"variant\": \"%s\", \"rows\": %d, \"cols\": %d, \"elapsed_s\": %.1f, \"finished\": %s, ",
+		p->name, board->rows, board->cols, elapsed, finished ? "true" : "false");
+	if(finished) n += snprintf(buf + n, size - n, "\"value\": %d, ", value);
+	n += snprintf(buf + n, size - n, "\"pass\": %d, \"window\": [%d, %d], \"root_done\": %d, \"root_pruned\": %d, "
+		"\"root_total\": %d, \"root\": [", p->passes, p->alpha, p->beta, p->root_done, p->root_pruned, p->root_total);
+	int searched = p->root_done - p->root_pruned;
+	for(int k=0; k<searched && n < size; ++k){
+		turn_t* t = board->turns[p->root_turn[k]];
+		n += snprintf(buf + n, size - n, "%s{\"turn\": \"%d %d %s\", \"value\": %d}", k ? ", " : "", t->row, t->col,
+			wall_name(t->wall), p->root_value[k]);
+	}
+	double eta = progress_eta(p, now);
+	if(n < size) n += snprintf(buf + n, size - n, "], \"turns\": %ld, \"turns_per_s\": %.0f, \"memo_entries\": %ld, "
+		"\"memo_mb\": %.1f, \"eta_s\": ", turns, elapsed > 0 ? turns / elapsed : 0, stored,
+		(stored * sizeof(memo_t) + (board->memo_hashtable ? ((size_t) 1 << board->memo_bits) * sizeof(memo_t*) : 0)) / 1048576.0);
+	if(n < size) n += eta < 0 || finished ? snprintf(buf + n, size - n, "null}\n") : snprintf(buf + n, size - n, "%.0f}\n", eta);
+	return n < size ? n : size - 1;
+}
+
+DNB_STATIC void progress_line(progress_t* p){
+	search_t* s = p->search;
+	double now = now_ms();
+	double elapsed = (now - p->start_ms) / 1e3;
+	long int turns = s->turn_count;
+	double eta = progress_eta(p, now);
+	fprintf(stderr, "[%7.1fs] window %d (%d, %d)  root %d/%d (%d pruned)  %.3g turns  %.3g/s  memo %ld", elapsed,
+		p->passes, p->alpha, p->beta, p->root_done, p->root_total, p->root_pruned, (double) turns,
+		elapsed > 0 ? turns / elapsed : 0, s->memo_stored);
+	if(eta >= 0) fprintf(stderr, "  eta %.0fs", eta);
+	fprintf(stderr, "\n");
+}
+
+/* write to a temporary file and rename it over the old one, so readers never see half of it */
+DNB_STATIC void progress_status(progress_t* p, bool finished, int value){
+	char tmp[512], buf[8192];
+	snprintf(tmp, sizeof(tmp), "%s.tmp", p->status_path);
+	FILE* f = fopen(tmp, "w");
+	if(f == NULL) return;
+	int n = progress_json(p, buf, sizeof(buf), finished, value);
+	fwrite(buf, 1, n, f);
+	fclose(f);
+	rename(tmp, p->status_path);
+}
+
+DNB_STATIC void* progress_thread(void* arg){
+	progress_t* p = (progress_t*) arg;
+	double next = now_ms() + p->interval_ms;
+	while(!p->stop){
+		struct pollfd pfd = {p->listen_fd, POLLIN, 0};
+		double wait = next - now_ms();
+		// wake up now and then to notice 'stop'
+		if(wait > 100) wait = 100;
+		if(poll(&pfd, p->listen_fd >= 0 ? 1 : 0, wait > 0 ? (int) wait : 0) > 0 && (pfd.revents & POLLIN)){
+			int client = accept(p->listen_fd, NULL, NULL);
+			if(client >= 0){
+				char buf[8192];
+				int n = progress_json(p, buf, sizeof(buf), false, 0);
+				if(write(client, buf, n) < 0){}
+				close(client);
+			}
+		}
+		if(now_ms() >= next){
+			progress_line(p);
+			if(p->status_path != NULL) progress_status(p, false, 0);
+			next += p->interval_ms;
+		}
+	}
+	return NULL;
+}
+
+DNB_STATIC int progress_listen(const char* path){
+	struct sockaddr_un addr;
+	if(strlen(path) >= sizeof(addr.sun_path)) return -1;
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(fd < 0) return -1;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+	unlink(path);
+	if(bind(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0 || listen(fd, 8) < 0){
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/* progress reports on 'search' (solving with the variant called 'name'), or null unless the
+	environment asks for them. start it after search_init() */
+DNB_STATIC progress_t* progress_from_env(search_t* search, const char* name){
+	const char* interval = getenv("DNB_PROGRESS");
+	const char* status = getenv("DNB_STATUS");
+	const char* sock = getenv("DNB_SOCKET");
+	if(interval == NULL && status == NULL && sock == NULL) return NULL;
+	progress_t* p = (progress_t*) calloc(1, sizeof(progress_t));
+	p->search = search;
+	p->name = name;
+	p->start_ms = now_ms();
+	p->pass_ms = p->start_ms;
+	p->interval_ms = interval != NULL && atof(interval) > 0 ? atof(interval) * 1e3 : 1e3;
+	p->status_path = status;
+	p->socket_path = sock;
+	p->listen_fd = -1;
+	if(sock != NULL){
+		p->listen_fd = progress_listen(sock);
+		if(p->listen_fd < 0) fprintf(stderr, "cannot listen on %s: %s\n", sock, strerror(errno));
+	}
+	if(pthread_create(&p->thread, NULL, progress_thread, p) != 0){
+		if(p->listen_fd >= 0) close(p->listen_fd);
+		free(p);
+		return NULL;
+	}
+	search->progress = p;
+	return p;
+}
+
+/* stop reporting, leaving the final result in the status file. 'p' may be null */
+DNB_STATIC void progress_stop(progress_t* p, int value){
+	if(p == NULL) return;
+	p->stop = true;
+	pthread_join(p->thread, NULL);
+	if(p->status_path != NULL) progress_status(p, true, value);
+	if(p->listen_fd >= 0){
+		close(p->listen_fd);
+		unlink(p->socket_path);
+	}
+	p->search->progress = NULL;
+	free(p);
+}
@@ -0,0 +1,283 @@
+#include <ctype.h>
+#include "dotsnboxes_db.h"
+
+/* One game played through a long-lived process, one text command at a time (solver_session reads
+	them from stdin, solver_server from many clients at once). The board and its table live from
+	one move to the next, and between moves the solver can ponder, i.e. search ahead while the
+	opponent thinks.
+
+	commands, each answered by one line:
+		new rows cols        a new game. "ok"
+		position text        any position, in the text form of position_t. "ok"
+		move index           a turn by wall_index(), or "move row col side" (top, bottom, left,
+		                     right), for whoever is to move. "ok" and the position after it
+		go                   choose a turn for whoever is to move, and play it:
+		                     "bestmove index row col SIDE value v turns n ms t", with the value
+		                     the final margin for the mover, or "?" if a limit hit first (the
+		                     turn is then the table's best guess, or a safe one)
+		show                 the position
+		ponder on|off
+		quit
+	anything else gets "error ...". since the table only depends on the walls, everything solved
+	for one move still holds for the next, and for later games of the same size; pondering is a
+	search of the position the opponent has to answer, which finds its best reply and leaves the
+	table ready for ours. a "go" for the predicted position is then mostly table lookups.
+
+	"go" is only started by session_command(): session_think() does the searching, all at once or
+	in slices of bounded time, so that one thread can take turns between many sessions. a search
+	cut short by the end of a slice keeps everything it finished in the table, and the next slice
+	starts over from the root, mostly on table lookups. */
+
+// what session_command() leaves to do
+#define SESSION_REPLY 0 // nothing: the reply is ready
+#define SESSION_GO 1 // think (session_think()) until it is
+#define SESSION_QUIT 2
+
+typedef struct Session{
+	board_t board;
+	bool has_board;
+	search_t search;
+	const char* name;
+	bool generic;
+	variant_t* variant;
+	position_t position; // the game; the board is only put in it when needed
+	double move_ms; // of thinking, for each "go"
+	long int move_turns;
+	long int budget; // table entries
+	long int entries; // about how many there are
+	int memo_bits; // size of the board's table, 0 for HASHTABLE_BITWIDTH
+	const solved_db_t* dbs; // tables of solved positions, one per board size, looked up under the board's
+	int n_dbs;
+	const book_t* books; // opening books, likewise
+	int n_books;
+	bool ponder;
+	// the pondering thread, which owns the board while it runs
+	pthread_t thread;
+	bool pondering;
+	volatile bool cancel;
+	// the "go" being thought about
+	bool thinking;
+	double think_ms;
+	long int think_turns;
+} session_t;
+
+/* a session with no game yet; the caller sets limits and options before the first command */
+void session_init(session_t* s){
+	memset(s, 0, sizeof(*s));
+	s->name = "ab_sym_memo_order";
+	s->budget = LONG_MAX;
+}
+
+/* put the board in the session's position */
+void session_board(session_t* s){
+	set_position(&s->board, s->position.walls, s->position.scores[0], s->position.scores[1], s->position.player);
+}
+
+void* ponder_thread(void* arg){
+	session_t* s = (session_t*) arg;
+	board_t* board = &s->board;
+	search_t* search = &s->search;
+	int player = s->position.player;
+	session_board(s);
+	search->turn_count = 0;
+	search->memo_stored = 0;
+	search->cancel = &s->cancel;
+	search_limit(search, 0, 0);
+	// follow the predicted line until it is the other player's turn to answer, which is solved
+	// too. the board is left wherever this stops: session_board() puts it back
+	while(!game_is_over(board)){
+		int value;
+		turn_t* best = s->variant->solve(search, predict_margin(board), &value);
+		if(search->aborted || board->player_turn != player) break;
+		execute_turn(best, board);
+		remove_turn_dll(best);
+		play_symmetries(best, board);
+	}
+	search->cancel = NULL;
+	return NULL;
+}
+
+/* stop pondering (keeping whatever it solved) */
+void ponder_stop(session_t* s){
+	if(!s->pondering) return;
+	s->cancel = true;
+	pthread_join(s->thread, NULL);
+	s->pondering = false;
+	s->entries += s->search.memo_stored;
+}
+
+void ponder_start(session_t* s){
+	if(!s->ponder || !s->has_board) return;
+	session_board(s);
+	if(game_is_over(&s->board)) return;
+	s->cancel = false;
+	s->pondering = pthread_create(&s->thread, NULL, ponder_thread, s) == 0;
+}
+
+/* a new position, checked. null if fine, otherwise what is wrong with it */
+const char* session_set(session_t* s, position_t* p){
+	if(p->rows < 1 || p->cols < 1 || p->rows > MAX_UID_WALLS || p->cols > MAX_UID_WALLS) return "bad size";
+	int walls = 2*p->rows*p->cols + p->rows + p->cols;
+	if(walls > MAX_UID_WALLS) return "too many walls for an exact solve";
+	if(walls < MAX_UID_WALLS && (p->walls >> walls) != 0) return "walls off the board";
+	if(p->player < 0 || p->player > 1 || p->scores[0] < 0 || p->scores[1] < 0) return "bad scores or player";
+	if(s->has_board && (s->board.rows != p->rows || s->board.cols != p->cols)){
+		PERF(perf_close(&s->search.perf);)
+		cleanup(&s->board);
+		s->has_board = false;
+		s->entries = 0;
+	}
+	if(!s->has_board){
+		init_board(&s->board, p->rows, p->cols);
+		if(s->memo_bits > 0) s->board.memo_bits = s->memo_bits;
+		s->board.solved = db_find(s->dbs, s->n_dbs, p->rows, p->cols);
+		s->board.book = book_find(s->books, s->n_books, p->rows, p->cols);
+		search_init(&s->search, &s->board);
+		s->variant = find_variant(s->name, p->rows, p->cols, s->generic);
+		s->has_board = true;
+	}
+	set_position(&s->board, p->walls, p->scores[0], p->scores[1], p->player);
+	if(boxes_closed(&s->board) != p->scores[0] + p->scores[1]) return "scores do not match the boxes";
+	s->position = *p;
+	return NULL;
+}
+
+/* the turn a "move" command names, or null */
+turn_t* parse_turn(session_t* s, const char* args){
+	int index, r, c;
+	char side[16];
+	board_t* board = &s->board;
+	if(sscanf(args, "%d %d %15s", &r, &c, side) == 3){
+		for(char* p = side; *p; ++p) *p = toupper((unsigned char) *p);
+		index = -1;
+		wall_t walls[] = {TOP, BOTTOM, LEFT, RIGHT};
+		for(int w=0; w<4; ++w)
+			if(strcmp(side, wall_name(walls[w])) == 0 && r >= 0 && r < board->rows && c >= 0 && c < board->cols)
+				index = wall_index(r, c, walls[w], board);
+	} else if(sscanf(args, "%d", &index) != 1) return NULL;
+	if(index < 0 || index >= n_walls(board) || (s->position.walls & board->turns[index]->uid)) return NULL;
+	return board->turns[index];
+}
+
+/* play 'turn' in the session's position */
+void session_play(session_t* s, turn_t* turn){
+	session_board(s);
+	execute_turn(turn, &s->board);
+	s->position.walls |= turn->uid;
+	s->position.scores[0] = s->board.scores[0];
+	s->position.scores[1] = s->board.scores[1];
+	s->position.player = s->board.player_turn;
+}
+
+/* a turn without a solve: the table's, else a capture, else one that gives nothing away */
+turn_t* fallback_turn(board_t* board){
+	memo_t* m = read_memo(board);
+	if(m != NULL) return board->turns[m->best_move];
+	turn_t* best = board->sentinel->next;
+	for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next)
+		if(turn_priority(t, board) > turn_priority(best, board)) best = t;
+	return best;
+}
+
+/* think about the "go" in progress for up to 'slice_ms' (0 for as long as it takes). true once
+	it is answered, into 'reply' (room for 'size' bytes), false if it needs another slice */
+bool session_think(session_t* s, double slice_ms, char* reply, int size){
+	board_t* board = &s->board;
+	search_t* search = &s->search;
+	session_board(s);
+	double ms = slice_ms;
+	if(s->move_ms > 0 && (ms == 0 || s->move_ms - s->think_ms < ms)) ms = s->move_ms - s->think_ms;
+	double start = now_ms();
+	search->turn_count = 0;
+	search->memo_stored = 0;
+	search_limit(search, s->move_turns > 0 ? s->move_turns - s->think_turns : 0, ms);
+	int value;
+	turn_t* best = s->variant->solve(search, predict_margin(board), &value);
+	bool exact = !search->aborted;
+	s->entries += search->memo_stored;
+	s->think_ms += now_ms() - start;
+	s->think_turns += search->turn_count;
+	bool out_of_time = (s->move_ms > 0 && s->think_ms >= s->move_ms) || (s->move_turns > 0 && s->think_turns >= s->move_turns);
+	if(!exact && !out_of_time) return false;
+	if(!exact) best = fallback_turn(board);
+	int n = snprintf(reply, size, "bestmove %d %d %d %s value ", best->index, best->row, best->col, wall_name(best->wall));
+	if(exact) n += snprintf(reply + n, size > n ? size - n : 0, "%d", value);
+	else n += snprintf(reply + n, size > n ? size - n : 0, "?");
+	snprintf(reply + n, size > n ? size - n : 0, " turns %ld ms %.1f", s->think_turns, s->think_ms);
+	s->thinking = false;
+	session_play(s, best);
+	// keep the table in bounds, but never drop what this search just used
+	if(s->entries > s->budget) s->entries -= age_memo(board, board->memo_generation - 1);
+	ponder_start(s);
+	return true;
+}
+
+/* carry out one command line, answering into 'reply' (room for 'size' bytes) unless it is a "go"
+	(SESSION_GO), which session_think() answers */
+int session_command(session_t* s, const char* line, char* reply, int size){
+	char command[16] = "";
+	int skip = 0;
+	reply[0] = '\0';
+	if(sscanf(line, "%15s %n", command, &skip) < 1) return SESSION_REPLY;
+	const char* args = line + skip;
+	if(strcmp(command, "quit") == 0) return SESSION_QUIT;
+	if(strcmp(command, "ponder") == 0){
+		s->ponder = strcmp(args, "off") != 0;
+		if(!s->ponder) ponder_stop(s);
+		snprintf(reply, size, "ok");
+	} else if(strcmp(command, "show") == 0){
+		if(s->has_board) format_position(&s->position, reply, size);
+		else snprintf(reply, size, "error no game");
+	} else if(strcmp(command, "new") == 0 || strcmp(command, "position") == 0){
+		position_t p;
+		const char* error = "cannot parse the position";
+		if(strcmp(command, "new") == 0){
+			memset(&p, 0, sizeof(p));
+			if(sscanf(args, "%d %d", &p.rows, &p.cols) == 2) error = NULL;
+		} else if(parse_position(args, &p)) error = NULL;
+		ponder_stop(s);
+		if(error == NULL) error = session_set(s, &p);
+		if(error != NULL) snprintf(reply, size, "error %s", error);
+		else snprintf(reply, size, "ok");
+		ponder_start(s);
+	} else if(!s->has_board){
+		snprintf(reply, size, "error no game");
+	} else if(strcmp(command, "move") == 0){
+		turn_t* turn = parse_turn(s, args);
+		if(turn == NULL){
+			snprintf(reply, size, "error illegal move");
+		} else{
+			char buf[128];
+			ponder_stop(s);
+			session_play(s, turn);
+			format_position(&s->position, buf, sizeof(buf));
+			snprintf(reply, size, "ok %s", buf);
+			ponder_start(s);
+		}
+	} else if(strcmp(command, "go") == 0){
+		ponder_stop(s);
+		session_board(s);
+		if(game_is_over(&s->board)){
+			snprintf(reply, size, "error game over");
+			ponder_start(s);
+			return SESSION_REPLY;
+		}
+		s->board.memo_generation++;
+		s->thinking = true;
+		s->think_ms = 0;
+		s->think_turns = 0;
+		return SESSION_GO;
+	} else{
+		snprintf(reply, size, "error unknown command '%s'", command);
+	}
+	return SESSION_REPLY;
+}
+
+void session_free(session_t* s){
+	ponder_stop(s);
+	if(s->has_board){
+		PERF(perf_close(&s->search.perf);)
+		cleanup(&s->board);
+	}
+	s->has_board = false;
+}
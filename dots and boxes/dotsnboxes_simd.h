@@ -0,0 +1,241 @@
+#include "dotsnboxes.h"
+
+/* Batched random playouts over bitboards. Each game is two 64-bit words (horizontal and vertical
+	walls) so a vector register holds one word of several independent games, one per lane:
+
+		AVX-512: 8 games    AVX2: 4 games    otherwise: 1 game (plain uint64_t)
+
+	Compile with -march=native (`make native`) to get the vector paths.
+
+	Both wall sets use a row stride of cols+1 so that the walls of box (r,c) all sit at the same
+	bit after a shift:
+
+		top = H[p]   bottom = H[p+S]   left = V[p]   right = V[p+1]     (p = r*S + c, S = cols+1)
+
+	which means (rows+1)*(cols+1) must fit in 64 bits: boards up to 7x7. Larger boards have to use
+	the scalar random_playout() in dotsnboxes_mcts.h. */
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define LANES 8
+typedef __m512i vec_t;
+#define V_SET1(x)      _mm512_set1_epi64((long long)(x))
+#define V_LOAD(p)      _mm512_loadu_si512((const void*)(p))
+#define V_STORE(p, x)  _mm512_storeu_si512((void*)(p), (x))
+#define V_AND(a, b)    _mm512_and_si512((a), (b))
+#define V_OR(a, b)     _mm512_or_si512((a), (b))
+#define V_XOR(a, b)    _mm512_xor_si512((a), (b))
+#define V_ANDNOT(a, b) _mm512_andnot_si512((a), (b)) /* ~a & b */
+#define V_ADD(a, b)    _mm512_add_epi64((a), (b))
+#define V_SUB(a, b)    _mm512_sub_epi64((a), (b))
+#define V_SHL(x, n)    _mm512_sll_epi64((x), _mm_cvtsi32_si128(n))
+#define V_SHR(x, n)    _mm512_srl_epi64((x), _mm_cvtsi32_si128(n))
+#define V_ROTL(x, r)   _mm512_rolv_epi64((x), (r))
+#define V_ROTR(x, r)   _mm512_rorv_epi64((x), (r))
+#define V_NONZERO(x)   _mm512_maskz_set1_epi64(_mm512_test_epi64_mask((x), (x)), -1)
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define LANES 4
+typedef __m256i vec_t;
+#define V_SET1(x)      _mm256_set1_epi64x((long long)(x))
+#define V_LOAD(p)      _mm256_loadu_si256((const __m256i*)(p))
+#define V_STORE(p, x)  _mm256_storeu_si256((__m256i*)(p), (x))
+#define V_AND(a, b)    _mm256_and_si256((a), (b))
+#define V_OR(a, b)     _mm256_or_si256((a), (b))
+#define V_XOR(a, b)    _mm256_xor_si256((a), (b))
+#define V_ANDNOT(a, b) _mm256_andnot_si256((a), (b))
+#define V_ADD(a, b)    _mm256_add_epi64((a), (b))
+#define V_SUB(a, b)    _mm256_sub_epi64((a), (b))
+#define V_SHL(x, n)    _mm256_sll_epi64((x), _mm_cvtsi32_si128(n))
+#define V_SHR(x, n)    _mm256_srl_epi64((x), _mm_cvtsi32_si128(n))
+// variable shifts by 64 give zero, which is exactly what a rotate by 0 needs
+#define V_ROTL(x, r)   _mm256_or_si256(_mm256_sllv_epi64((x), (r)), _mm256_srlv_epi64((x), _mm256_sub_epi64(_mm256_set1_epi64x(64), (r))))
+#define V_ROTR(x, r)   _mm256_or_si256(_mm256_srlv_epi64((x), (r)), _mm256_sllv_epi64((x), _mm256_sub_epi64(_mm256_set1_epi64x(64), (r))))
+#define V_NONZERO(x)   _mm256_xor_si256(_mm256_cmpeq_epi64((x), _mm256_setzero_si256()), _mm256_set1_epi64x(-1))
+#else
+#define LANES 1
+typedef uint64_t vec_t;
+#define V_SET1(x)      ((uint64_t)(x))
+#define V_LOAD(p)      (*(const uint64_t*)(p))
+#define V_STORE(p, x)  (*(uint64_t*)(p) = (x))
+#define V_AND(a, b)    ((a) & (b))
+#define V_OR(a, b)     ((a) | (b))
+#define V_XOR(a, b)    ((a) ^ (b))
+#define V_ANDNOT(a, b) (~(a) & (b))
+#define V_ADD(a, b)    ((a) + (b))
+#define V_SUB(a, b)    ((a) - (b))
+#define V_SHL(x, n)    ((x) << (n))
+#define V_SHR(x, n)    ((x) >> (n))
+#define V_ROTL(x, r)   (((x) << (r)) | ((x) >> ((64 - (r)) & 63)))
+#define V_ROTR(x, r)   (((x) >> (r)) | ((x) << ((64 - (r)) & 63)))
+#define V_NONZERO(x)   ((x) ? ~(uint64_t)0 : 0)
+#endif
+
+// per-lane select: m ? a : b (m must be all-ones or all-zeros in each lane)
+#define V_SELECT(m, a, b) V_OR(V_AND((m), (a)), V_ANDNOT((m), (b)))
+
+typedef struct BitLayout{
+	int rows;
+	int cols;
+	int stride;
+	uint64_t h_mask;   // valid horizontal wall bits
+	uint64_t v_mask;   // valid vertical wall bits
+	uint64_t box_mask; // valid box bits
+} bitlayout_t;
+
+typedef struct BitGame{
+	uint64_t h;  // drawn horizontal walls
+	uint64_t v;  // drawn vertical walls
+	int diff;    // player 0's score minus player 1's
+	int player;  // player to move
+} bitgame_t;
+
+/* returns false if the board is too large for one 64-bit word per wall set */
+bool bitlayout_init(bitlayout_t* layout, int rows, int cols){
+	int stride = cols + 1;
+	if((rows + 1) * stride > 64) return false;
+	layout->rows = rows;
+	layout->cols = cols;
+	layout->stride = stride;
+	layout->h_mask = layout->v_mask = layout->box_mask = 0;
+	for(int r=0; r<=rows; ++r){
+		for(int c=0; c<=cols; ++c){
+			uint64_t bit = (uint64_t)1 << (r*stride + c);
+			if(c < cols) layout->h_mask |= bit;
+			if(r < rows) layout->v_mask |= bit;
+			if(r < rows && c < cols) layout->box_mask |= bit;
+		}
+	}
+	return true;
+}
+
+void board_to_bitgame(board_t* board, bitlayout_t* layout, bitgame_t* game){
+	int s = layout->stride;
+	game->h = game->v = 0;
+	for(int r=0; r<board->rows; ++r){
+		for(int c=0; c<board->cols; ++c){
+			square_t sq = board->squares[r*board->cols + c];
+			int p = r*s + c;
+			if(sq & TOP)    game->h |= (uint64_t)1 << p;
+			if(sq & BOTTOM) game->h |= (uint64_t)1 << (p + s);
+			if(sq & LEFT)   game->v |= (uint64_t)1 << p;
+			if(sq & RIGHT)  game->v |= (uint64_t)1 << (p + 1);
+		}
+	}
+	game->diff = board->scores[0] - board->scores[1];
+	game->player = board->player_turn;
+}
+
+/* one random set bit of x in each lane, or 0 where x is 0. rotating by a random amount and taking
+	the lowest set bit is not exactly uniform, but it is branch-free and good enough for playouts */
+vec_t random_bit(vec_t x, vec_t rnd){
+	vec_t r = V_AND(rnd, V_SET1(63));
+	vec_t rot = V_ROTR(x, r);
+	vec_t low = V_AND(rot, V_SUB(V_SET1(0), rot));
+	return V_ROTL(low, r);
+}
+
+/* play LANES games to the end with the capture-aware policy from random_playout(): take a free
+	box if there is one, otherwise avoid drawing a third side if possible */
+void bit_playout_lanes(bitlayout_t* layout, bitgame_t* games, int* margins, uint64_t* rng){
+	uint64_t buf_h[LANES], buf_v[LANES], buf_d[LANES], buf_p[LANES];
+	int steps = 0;
+	for(int l=0; l<LANES; ++l){
+		buf_h[l] = games[l].h;
+		buf_v[l] = games[l].v;
+		buf_d[l] = (uint64_t)(int64_t) games[l].diff;
+		buf_p[l] = games[l].player ? ~(uint64_t)0 : 0;
+		// every lane has to run until its last wall is drawn
+		int left = 0;
+		for(uint64_t w = layout->h_mask & ~games[l].h; w; w &= w - 1) left++;
+		for(uint64_t w = layout->v_mask & ~games[l].v; w; w &= w - 1) left++;
+		if(left > steps) steps = left;
+	}
+	int s = layout->stride;
+	vec_t h = V_LOAD(buf_h), v = V_LOAD(buf_v), diff = V_LOAD(buf_d), pm = V_LOAD(buf_p);
+	vec_t box = V_SET1(layout->box_mask), h_mask = V_SET1(layout->h_mask), v_mask = V_SET1(layout->v_mask);
+	vec_t ones = V_SET1(-1), one = V_SET1(1);
+	vec_t x = V_LOAD(rng);
+
+	for(int step=0; step<steps; ++step){
+		// sides of every box, as four aligned masks
+		vec_t a = V_AND(h, box);
+		vec_t b = V_AND(V_SHR(h, s), box);
+		vec_t c = V_AND(v, box);
+		vec_t d = V_AND(V_SHR(v, 1), box);
+		// bit-sliced count of sides: a+b+c+d = ones + 2*twos + 4*fours
+		vec_t s1 = V_XOR(a, b), c1 = V_AND(a, b);
+		vec_t s2 = V_XOR(c, d), c2 = V_AND(c, d);
+		vec_t bit_1 = V_XOR(s1, s2), carry = V_AND(s1, s2);
+		vec_t bit_2 = V_XOR(V_XOR(c1, c2), carry);
+		vec_t bit_4 = V_OR(V_AND(c1, c2), V_AND(carry, V_OR(c1, c2)));
+		vec_t three = V_AND(bit_1, bit_2);
+		vec_t two = V_ANDNOT(V_OR(bit_1, bit_4), bit_2);
+		vec_t done = bit_4;
+
+		// the missing side of a three-sided box is a capture
+		vec_t cap_h = V_OR(V_ANDNOT(a, three), V_SHL(V_ANDNOT(b, three), s));
+		vec_t cap_v = V_OR(V_ANDNOT(c, three), V_SHL(V_ANDNOT(d, three), 1));
+		// any side of a two-sided box would give one away
+		vec_t free_h = V_ANDNOT(h, h_mask), free_v = V_ANDNOT(v, v_mask);
+		vec_t safe_h = V_ANDNOT(V_OR(two, V_SHL(two, s)), free_h);
+		vec_t safe_v = V_ANDNOT(V_OR(two, V_SHL(two, 1)), free_v);
+
+		vec_t has_cap = V_NONZERO(V_OR(cap_h, cap_v));
+		vec_t has_safe = V_NONZERO(V_OR(safe_h, safe_v));
+		vec_t mh = V_SELECT(has_cap, cap_h, V_SELECT(has_safe, safe_h, free_h));
+		vec_t mv = V_SELECT(has_cap, cap_v, V_SELECT(has_safe, safe_v, free_v));
+
+		// xorshift64 in every lane
+		x = V_XOR(x, V_SHL(x, 13));
+		x = V_XOR(x, V_SHR(x, 7));
+		x = V_XOR(x, V_SHL(x, 17));
+
+		// pick horizontal or vertical (coin flip when both are possible), then a bit within it
+		vec_t any_h = V_NONZERO(mh), any_v = V_NONZERO(mv);
+		vec_t coin = V_NONZERO(V_AND(x, V_SET1(64)));
+		vec_t use_h = V_AND(any_h, V_OR(V_XOR(any_v, ones), coin));
+		vec_t pick_h = random_bit(mh, x);
+		vec_t pick_v = random_bit(mv, V_SHR(x, 8));
+		h = V_OR(h, V_AND(use_h, pick_h));
+		v = V_OR(v, V_ANDNOT(use_h, pick_v));
+
+		// score whatever got closed; one wall closes at most two boxes
+		vec_t closed = V_ANDNOT(done, V_AND(V_AND(h, V_SHR(h, s)), V_AND(V_AND(v, V_SHR(v, 1)), box)));
+		vec_t any = V_NONZERO(closed);
+		vec_t both = V_NONZERO(V_AND(closed, V_SUB(closed, one)));
+		vec_t delta = V_ADD(V_AND(any, one), V_AND(both, one));
+		// negate for player 1, then pass the turn if nothing was closed
+		diff = V_ADD(diff, V_SUB(V_XOR(delta, pm), pm));
+		pm = V_XOR(pm, V_ANDNOT(any, ones));
+	}
+
+	V_STORE(buf_d, diff);
+	V_STORE(rng, x);
+	for(int l=0; l<LANES; ++l)
+		margins[l] = (int)(int64_t) buf_d[l];
+}
+
+/* play n games from the given starting positions; margins[i] gets player 0's final lead */
+void bit_playouts(bitlayout_t* layout, bitgame_t* games, int* margins, int n, uint64_t* rng){
+	bitgame_t chunk[LANES];
+	int out[LANES];
+	for(int i=0; i<n; i+=LANES){
+		int m = n - i < LANES ? n - i : LANES;
+		// pad a short final chunk with copies of its first game
+		for(int l=0; l<LANES; ++l) chunk[l] = games[i + (l < m ? l : 0)];
+		bit_playout_lanes(layout, chunk, out, rng);
+		for(int l=0; l<m; ++l) margins[i + l] = out[l];
+	}
+}
+
+/* LANES independent seeds for the vector generator */
+void seed_lanes(uint64_t* rng, uint64_t seed){
+	for(int l=0; l<LANES; ++l){
+		// splitmix64 so that neighbouring lanes do not start correlated
+		uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		rng[l] = (z ^ (z >> 31)) | 1;
+	}
+}
@@ -0,0 +1,197 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+/* Binary search traces, in place of printing every node. Debug builds ("make debug") keep a ring
+	buffer of small fixed-size records per search, and so per thread, as no two threads share a
+	search: node entries, turns tried, memo hits, ETC and symmetry prunes, cutoffs, aspiration
+	windows and returned values. The records only reach the disk when the program exits, or on
+	SIGINT/SIGTERM (before dying) or SIGUSR1 (snapshot, and the search carries on); trace_decode
+	prints them back as an indented tree.
+
+	Tracing is off unless the environment asks for it:
+		DNB_TRACE=file          where to dump (file.1, file.2... for further searches)
+		DNB_TRACE_SAMPLE=n[@d]  only trace one in n of the subtrees at depth d (default 4), so that
+		                        big solves leave a readable sample; everything above d is kept
+		DNB_TRACE_BITS=b        2^b records in the ring (default 20, 16MB; at most 26, 1GB): the
+		                        oldest are overwritten, so this is how much of the end of the
+		                        search survives
+	Outside debug builds TRACE(...) drops its argument and none of this is compiled in. */
+
+#ifdef DEBUG
+#define TRACE(...) __VA_ARGS__
+#else
+#define TRACE(...)
+#endif
+
+#define TRACE_MAGIC "DNBTRACE"
+#define TRACE_VERSION 1
+#define TRACE_NONE 255 // no turn
+#define MAX_TRACES 64
+#define TRACE_MAX_BITS 26
+
+enum TraceKind{
+	TRACE_NODE,   // entered a position with window (alpha, beta)
+	TRACE_MOVE,   // trying 'index'; value is the margin after it
+	TRACE_MEMO,   // table hit: value and bound (as stored, from the mover's side)
+	TRACE_ETC,    // child 'index' found in the table refutes the window with value
+	TRACE_SYM,    // 'index' skipped as the mirror image, by symmetry 'value', of a searched turn
+	TRACE_CUTOFF, // 'index' made beta <= alpha, with value
+	TRACE_RETURN, // leaving the node with value (a bound if outside the node's window), best turn 'index'
+	TRACE_WINDOW, // aspiration window (alpha, beta) at the root
+	N_TRACE_KINDS
+};
+
+/* 16 bytes. scores never get near the int8 limits; the infinite windows are clamped */
+typedef struct TraceRecord{
+	bid_t uid;
+	uint8_t kind, depth, index, bound;
+	int8_t value, alpha, beta, player;
+} trace_record_t;
+
+/* the start of a dump, followed by min(written, capacity) records, oldest first */
+typedef struct TraceHeader{
+	char magic[8];
+	uint32_t version;
+	uint32_t rows, cols;
+	uint32_t sample, sample_depth;
+	uint32_t capacity;
+	uint64_t written;
+} trace_header_t;
+
+typedef struct Trace{
+	trace_record_t* ring;
+	uint64_t mask;
+	uint64_t written;
+	int rows, cols;
+	int sample, sample_depth;
+	long int subtrees; // seen at sample_depth
+	bool on; // in a sampled subtree
+	char path[256];
+} trace_t;
+
+#ifdef DEBUG
+// every trace made, to dump at exit. searches in other threads may add theirs at any time
+DNB_STATIC trace_t* traces[MAX_TRACES];
+DNB_STATIC int n_traces = 0;
+DNB_STATIC pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+DNB_STATIC int8_t trace_clamp(int v){
+	return v > 127 ? 127 : (v < -127 ? -127 : v);
+}
+
+DNB_STATIC void trace_record(trace_t* t, int kind, int depth, bid_t uid, int index, int player, int value, int bound, int alpha, int beta){
+	if(kind == TRACE_NODE && depth == t->sample_depth) t->on = t->subtrees++ % t->sample == 0;
+	if(depth >= t->sample_depth && !t->on) return;
+	trace_record_t* r = &t->ring[t->written++ & t->mask];
+	r->uid = uid;
+	r->kind = kind;
+	r->depth = depth;
+	r->index = index;
+	r->bound = bound;
+	r->value = trace_clamp(value);
+	r->alpha = trace_clamp(alpha);
+	r->beta = trace_clamp(beta);
+	r->player = player;
+}
+
+/* only write() and friends, so that it can run in a signal handler */
+DNB_STATIC void trace_write_all(int fd, const void* data, size_t size){
+	const char* p = (const char*) data;
+	while(size > 0){
+		ssize_t n = write(fd, p, size);
+		if(n <= 0) return;
+		p += n;
+		size -= n;
+	}
+}
+
+DNB_STATIC void trace_dump(trace_t* t){
+	int fd = open(t->path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0) return;
+	trace_header_t h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, TRACE_MAGIC, sizeof(h.magic));
+	h.version = TRACE_VERSION;
+	h.rows = t->rows;
+	h.cols = t->cols;
+	h.sample = t->sample;
+	h.sample_depth = t->sample_depth;
+	h.capacity = t->mask + 1;
+	h.written = t->written;
+	trace_write_all(fd, &h, sizeof(h));
+	uint64_t capacity = t->mask + 1;
+	if(t->written <= capacity){
+		trace_write_all(fd, t->ring, t->written * sizeof(trace_record_t));
+	} else{
+		// wrapped: the oldest record is the next one to be overwritten
+		uint64_t start = t->written & t->mask;
+		trace_write_all(fd, t->ring + start, (capacity - start) * sizeof(trace_record_t));
+		trace_write_all(fd, t->ring, start * sizeof(trace_record_t));
+	}
+	close(fd);
+}
+
+DNB_STATIC void trace_dump_all(){
+	// no lock: this runs in signal handlers. a trace is only counted once it is complete
+	int n = __atomic_load_n(&n_traces, __ATOMIC_ACQUIRE);
+	for(int k=0; k<n; ++k) trace_dump(traces[k]);
+}
+
+DNB_STATIC void trace_signal(int sig){
+	trace_dump_all();
+	if(sig == SIGUSR1) return;
+	signal(sig, SIG_DFL);
+	raise(sig);
+}
+
+/* a trace for a search of 'board', or null unless DNB_TRACE asks for one (or there is no
+	memory for its ring) */
+DNB_STATIC trace_t* trace_from_env(board_t* board){
+	const char* path = getenv("DNB_TRACE");
+	if(path == NULL || *path == '\0') return NULL;
+	trace_t* t = (trace_t*) calloc(1, sizeof(trace_t));
+	if(t == NULL) return NULL;
+	const char* bits = getenv("DNB_TRACE_BITS");
+	int b = bits != NULL ? atoi(bits) : 20;
+	if(b < 4 || b > TRACE_MAX_BITS) b = 20;
+	t->mask = ((uint64_t) 1 << b) - 1;
+	t->ring = (trace_record_t*) malloc(sizeof(trace_record_t) * (t->mask + 1));
+	if(t->ring == NULL){
+		free(t);
+		return NULL;
+	}
+	t->rows = board->rows;
+	t->cols = board->cols;
+	t->sample = 1;
+	t->sample_depth = 4;
+	const char* sample = getenv("DNB_TRACE_SAMPLE");
+	if(sample != NULL) sscanf(sample, "%d@%d", &t->sample, &t->sample_depth);
+	if(t->sample < 1) t->sample = 1;
+	if(t->sample_depth < 0) t->sample_depth = 0;
+	pthread_mutex_lock(&trace_lock);
+	if(n_traces == MAX_TRACES){
+		pthread_mutex_unlock(&trace_lock);
+		free(t->ring);
+		free(t);
+		return NULL;
+	}
+	if(n_traces == 0) snprintf(t->path, sizeof(t->path), "%s", path);
+	else snprintf(t->path, sizeof(t->path), "%s.%d", path, n_traces);
+	if(n_traces == 0){
+		atexit(trace_dump_all);
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_handler = trace_signal;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGINT, &action, NULL);
+		sigaction(SIGTERM, &action, NULL);
+		sigaction(SIGUSR1, &action, NULL);
+	}
+	traces[n_traces] = t;
+	__atomic_store_n(&n_traces, n_traces + 1, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&trace_lock);
+	return t;
+}
+#endif
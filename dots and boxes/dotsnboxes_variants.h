@@ -0,0 +1,337 @@
+#include "dotsnboxes.h"
+#include "dotsnboxes_tables.h"
+#include "dotsnboxes_counters.h"
+#include "dotsnboxes_perf.h"
+#include "dotsnboxes_trace.h"
+
+/* state shared by the whole search, so that recursion only passes what changes per node */
+typedef struct Search{
+	board_t* board;
+	int maximizer;
+	long int turn_count; // calls of execute_turn, for stats on pruning factor
+	long int memo_probes; // read_memo() calls...
+	long int memo_hits; // ...and how many found the position
+	long int memo_stored; // positions added to the table
+	// optional limits (search_limit()). the search only looks at the clock, and at its limits,
+	// once turn_count reaches next_poll, so without any it never does
+	long int turn_limit;
+	double deadline_ms; // against now_ms(), 0 for none
+	long int next_poll;
+	bool aborted; // hit a limit: the search unwound without a result
+	volatile bool* cancel; // if not null, another thread can stop the search by setting it
+	struct Progress* progress; // live reports (dotsnboxes_progress.h), or null
+	COUNT(counters_t counters;)
+	PERF(perf_t perf;) // open from search_init(); perf_close() when done
+	TRACE(trace_t* trace;) // null unless the caller attaches one
+} search_t;
+
+#include "dotsnboxes_progress.h"
+
+/* what perft() adds up at each ply below its position (1 for the position's own turns), besides
+	the leaves */
+typedef struct PerftCounts{
+	long int captures[MAX_DEPTH]; // boxes completed by the turns at that ply
+	long int player0_captures[MAX_DEPTH]; // of them, by player 0
+	long int extra_turns[MAX_DEPTH]; // those turns after which the same player moves again
+} perft_counts_t;
+
+// turns between looks at the clock
+#define POLL_INTERVAL 4096
+
+/* called by the engine when turn_count reaches next_poll */
+DNB_STATIC void search_poll(search_t* search){
+	if(search->turn_count >= search->turn_limit || (search->deadline_ms > 0 && now_ms() >= search->deadline_ms) ||
+		(search->cancel != NULL && *search->cancel)){
+		search->aborted = true;
+		search->next_poll = LONG_MAX;
+		return;
+	}
+	bool periodic = search->deadline_ms > 0 || search->cancel != NULL;
+	search->next_poll = periodic ? search->turn_count + POLL_INTERVAL : search->turn_limit;
+	if(search->next_poll > search->turn_limit) search->next_poll = search->turn_limit;
+}
+
+/* stop the search after 'turns' more turns or 'ms' milliseconds from now, whichever comes first
+	(0 for no limit), or once *search->cancel is set. it then unwinds without a result, and leaves
+	the table as valid as before */
+DNB_STATIC void search_limit(search_t* search, long int turns, double ms){
+	search->turn_limit = turns > 0 ? search->turn_count + turns : LONG_MAX;
+	search->deadline_ms = ms > 0 ? now_ms() + ms : 0;
+	search->aborted = false;
+	search->next_poll = search->turn_count;
+	search_poll(search);
+}
+
+/* every solver variant: one instantiation of dotsnboxes_engine.h per combination of policies */
+
+#define ENGINE_NAME brute
+#define ENGINE_AB 0
+#define ENGINE_SYM 0
+#define ENGINE_MEMO 0
+#define ENGINE_ORDER 0
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab
+#define ENGINE_AB 1
+#define ENGINE_SYM 0
+#define ENGINE_MEMO 0
+#define ENGINE_ORDER 0
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME brute_sym
+#define ENGINE_AB 0
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 0
+#define ENGINE_ORDER 0
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab_sym
+#define ENGINE_AB 1
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 0
+#define ENGINE_ORDER 0
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME brute_memo
+#define ENGINE_AB 0
+#define ENGINE_SYM 0
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 0
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab_memo
+#define ENGINE_AB 1
+#define ENGINE_SYM 0
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 0
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME sym_memo
+#define ENGINE_AB 0
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 0
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab_sym_memo
+#define ENGINE_AB 1
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 0
+#include "dotsnboxes_engine.h"
+
+// move ordering only pays off when there is a window to cut against
+#define ENGINE_NAME ab_order
+#define ENGINE_AB 1
+#define ENGINE_SYM 0
+#define ENGINE_MEMO 0
+#define ENGINE_ORDER 1
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab_sym_order
+#define ENGINE_AB 1
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 0
+#define ENGINE_ORDER 1
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab_memo_order
+#define ENGINE_AB 1
+#define ENGINE_SYM 0
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 1
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab_sym_memo_order
+#define ENGINE_AB 1
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 1
+#include "dotsnboxes_engine.h"
+
+// fixed-size kernels of the default variant, for the sizes in gen_tables.c
+#define ENGINE_NAME ab_sym_memo_order_2x2
+#define ENGINE_AB 1
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 1
+#define ENGINE_ROWS 2
+#define ENGINE_COLS 2
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab_sym_memo_order_2x3
+#define ENGINE_AB 1
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 1
+#define ENGINE_ROWS 2
+#define ENGINE_COLS 3
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab_sym_memo_order_3x3
+#define ENGINE_AB 1
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 1
+#define ENGINE_ROWS 3
+#define ENGINE_COLS 3
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab_sym_memo_order_3x4
+#define ENGINE_AB 1
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 1
+#define ENGINE_ROWS 3
+#define ENGINE_COLS 4
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab_sym_memo_order_4x4
+#define ENGINE_AB 1
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 1
+#define ENGINE_ROWS 4
+#define ENGINE_COLS 4
+#include "dotsnboxes_engine.h"
+
+#define ENGINE_NAME ab_sym_memo_order_5x5
+#define ENGINE_AB 1
+#define ENGINE_SYM 1
+#define ENGINE_MEMO 1
+#define ENGINE_ORDER 1
+#define ENGINE_ROWS 5
+#define ENGINE_COLS 5
+#include "dotsnboxes_engine.h"
+
+typedef turn_t* (*solve_fn)(search_t* search, int guess, int* final_value);
+typedef long int (*perft_fn)(board_t* board, int depth, int ply, perft_counts_t* counts);
+typedef struct Variant{
+	const char* name;
+	int rows, cols; // 0 for any size
+	solve_fn solve;
+	perft_fn perft; // with the variant's board functions, which only differ for fixed sizes
+} variant_t;
+
+DNB_STATIC variant_t variants[] = {
+	{"brute", 0, 0, solve_brute, perft_brute},
+	{"ab", 0, 0, solve_ab, perft_ab},
+	{"brute_sym", 0, 0, solve_brute_sym, perft_brute_sym},
+	{"ab_sym", 0, 0, solve_ab_sym, perft_ab_sym},
+	{"brute_memo", 0, 0, solve_brute_memo, perft_brute_memo},
+	{"ab_memo", 0, 0, solve_ab_memo, perft_ab_memo},
+	{"sym_memo", 0, 0, solve_sym_memo, perft_sym_memo},
+	{"ab_sym_memo", 0, 0, solve_ab_sym_memo, perft_ab_sym_memo},
+	{"ab_order", 0, 0, solve_ab_order, perft_ab_order},
+	{"ab_sym_order", 0, 0, solve_ab_sym_order, perft_ab_sym_order},
+	{"ab_memo_order", 0, 0, solve_ab_memo_order, perft_ab_memo_order},
+	{"ab_sym_memo_order", 0, 0, solve_ab_sym_memo_order, perft_ab_sym_memo_order},
+	{"ab_sym_memo_order", 2, 2, solve_ab_sym_memo_order_2x2, perft_ab_sym_memo_order_2x2},
+	{"ab_sym_memo_order", 2, 3, solve_ab_sym_memo_order_2x3, perft_ab_sym_memo_order_2x3},
+	{"ab_sym_memo_order", 3, 3, solve_ab_sym_memo_order_3x3, perft_ab_sym_memo_order_3x3},
+	{"ab_sym_memo_order", 3, 4, solve_ab_sym_memo_order_3x4, perft_ab_sym_memo_order_3x4},
+	{"ab_sym_memo_order", 4, 4, solve_ab_sym_memo_order_4x4, perft_ab_sym_memo_order_4x4},
+	{"ab_sym_memo_order", 5, 5, solve_ab_sym_memo_order_5x5, perft_ab_sym_memo_order_5x5},
+};
+#define N_VARIANTS (int)(sizeof(variants) / sizeof(variants[0]))
+
+/* a root turn and its exact value (final margin for the player to move at the root) */
+typedef struct MoveValue{
+	turn_t* turn;
+	long int turns; // searched for it
+	double ms;
+	int value;
+} move_value_t;
+
+/* best first, then in turn order */
+DNB_STATIC int by_value(const void* a, const void* b){
+	const move_value_t* p = (const move_value_t*) a;
+	const move_value_t* q = (const move_value_t*) b;
+	return p->value != q->value ? q->value - p->value : p->turn->index - q->turn->index;
+}
+
+/* the exact value of every legal turn from the search's position, best first, into 'out' (room
+	for n_walls()). returns how many, or -1 if the search hit one of its limits.
+	the position is solved first (with its window around 'guess', as solve() has it), and every
+	turn after it searched with its window around that value: with a table, the best turns'
+	subtrees are then mostly there already, and a turn that is as good as the best (there are
+	usually many) is proved so by a search that barely opens its window. only the worse ones need
+	re-searching, with windows widened towards their real values. turns that a symmetry of the
+	position maps onto one already searched just copy its value */
+DNB_STATIC int analyze_moves(search_t* search, variant_t* variant, int guess, move_value_t* out){
+	board_t* board = search->board;
+	int player = board->player_turn;
+	int root_value;
+	variant->solve(search, guess, &root_value);
+	if(search->aborted) return -1;
+	bool symmetries[MAX_SYMMETRIES];
+	for(int s=1; s<board->n_lists; ++s) symmetries[s] = has_symmetry(board, s);
+	int value_of[MAX_UID_WALLS];
+	bid_t done = 0;
+	int n = 0;
+	for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next){
+		long int start = search->turn_count;
+		double start_ms = now_ms();
+		int value = INT_MIN;
+		for(int s=1; s<board->n_lists && value == INT_MIN; ++s){
+			if(!symmetries[s]) continue;
+			if(t->pairs[s] != NULL && (done & t->pairs[s]->uid)) value = value_of[t->pairs[s]->index];
+			else if(t->inverse_pairs[s] != NULL && (done & t->inverse_pairs[s]->uid)) value = value_of[t->inverse_pairs[s]->index];
+		}
+		if(value == INT_MIN){
+			execute_turn(t, board);
+			turn_t* memo = remove_turn_dll(t);
+			play_symmetries(t, board);
+			// a capture keeps the turn, and the value the mover's
+			bool same = board->player_turn == player;
+			value = board->scores[player] - board->scores[1-player];
+			if(!game_is_over(board)){
+				variant->solve(search, same ? root_value : -root_value, &value);
+				if(!same) value = -value;
+			}
+			unplay_symmetries(t, board);
+			add_turn_dll(memo, t);
+			unexecute_turn(t, board);
+			if(search->aborted) return -1;
+		}
+		value_of[t->index] = value;
+		done |= t->uid;
+		out[n].turn = t;
+		out[n].value = value;
+		out[n].turns = search->turn_count - start;
+		out[n].ms = now_ms() - start_ms;
+		++n;
+	}
+	qsort(out, n, sizeof(move_value_t), by_value);
+	return n;
+}
+
+/* the variant called 'name' for a rows x cols board: its fixed-size kernel if there is one (and
+	'generic' is false), otherwise the one for any size. null if there is no such variant */
+DNB_STATIC variant_t* find_variant(const char* name, int rows, int cols, bool generic){
+	variant_t* found = NULL;
+	for(int v=0; v<N_VARIANTS; ++v){
+		if(strcmp(variants[v].name, name) != 0) continue;
+		if(variants[v].rows == 0 && found == NULL) found = &variants[v];
+		if(!generic && variants[v].rows == rows && variants[v].cols == cols) return &variants[v];
+	}
+	return found;
+}
+
+DNB_STATIC void search_init(search_t* search, board_t* board){
+	search->board = board;
+	search->maximizer = board->player_turn;
+	search->turn_count = 0;
+	search->memo_probes = 0;
+	search->memo_hits = 0;
+	search->memo_stored = 0;
+	search->progress = NULL;
+	search->turn_limit = LONG_MAX;
+	search->deadline_ms = 0;
+	search->next_poll = LONG_MAX;
+	search->aborted = false;
+	search->cancel = NULL;
+	COUNT(counters_init(&search->counters, board);)
+	PERF(perf_open(&search->perf);)
+	TRACE(search->trace = NULL;)
+}
@@ -0,0 +1,72 @@
+#include "dotsnboxes.h"
+
+/* writes dotsnboxes_tables.h: read-only tables for the board sizes that the solver has
+	fixed-size kernels for (see dotsnboxes_variants.h), so that nothing about those boards has to
+	be worked out from rows and cols while searching. usage: gen_tables > dotsnboxes_tables.h */
+
+int sizes[][2] = {{2, 2}, {2, 3}, {3, 3}, {3, 4}, {4, 4}, {5, 5}};
+#define N_SIZES (int)(sizeof(sizes) / sizeof(sizes[0]))
+
+void print_uids(const char* name, board_t* board, bool inverse){
+	int w_max = n_walls(board);
+	printf("DNB_STATIC const uint64_t %s_%dx%d[%d][%d] = {\n", name, board->rows, board->cols, MAX_SYMMETRIES, w_max);
+	for(int s=0; s<MAX_SYMMETRIES; ++s){
+		printf("\t{");
+		for(int w=0; w<w_max; ++w){
+			turn_t* t = board->turns[w];
+			turn_t* pair = s == 0 || s >= board->n_lists ? NULL : (inverse ? t->inverse_pairs[s] : t->pairs[s]);
+			printf("0x%llxULL%s", pair == NULL ? 0ULL : (unsigned long long) pair->uid, w+1 < w_max ? ", " : "");
+		}
+		printf("}%s\n", s+1 < MAX_SYMMETRIES ? "," : "");
+	}
+	printf("};\n");
+}
+
+int main(){
+	printf("/* generated by gen_tables.c -- do not edit */\n");
+	printf("#include <stddef.h>\n");
+	printf("#include <stdint.h>\n\n");
+	printf("/* DNB_STATIC is in dotsnboxes.h, which is included first */\n\n");
+	for(int k=0; k<N_SIZES; ++k){
+		board_t board;
+		init_board(&board, sizes[k][0], sizes[k][1]);
+		int rows = board.rows, cols = board.cols, w_max = n_walls(&board);
+		printf("/* %dx%d */\n", rows, cols);
+
+		// per wall: the squares it borders (-1 past the edge) and which side of each it is
+		printf("DNB_STATIC const signed char wall_squares_%dx%d[%d][2] = {", rows, cols, w_max);
+		for(int w=0; w<w_max; ++w){
+			turn_t* t = board.turns[w];
+			printf("{%d, %d}%s", t->row*cols + t->col, opposite(t->row, t->col, t->wall, &board), w+1 < w_max ? ", " : "");
+		}
+		printf("};\n");
+		printf("DNB_STATIC const unsigned char wall_sides_%dx%d[%d][2] = {", rows, cols, w_max);
+		for(int w=0; w<w_max; ++w){
+			wall_t wall = board.turns[w]->wall;
+			wall_t other = wall & TOP_OR_BOTTOM ? wall ^ TOP_OR_BOTTOM : wall ^ LEFT_OR_RIGHT;
+			printf("{%d, %d}%s", wall, other, w+1 < w_max ? ", " : "");
+		}
+		printf("};\n");
+
+		// per symmetry: the i.d. bit of the wall each wall maps onto, and of the one mapping onto
+		// it. zero when a wall maps onto itself or the symmetry does not apply to this shape
+		print_uids("wall_images", &board, false);
+		print_uids("wall_preimages", &board, true);
+
+		// the same keys pns_init() draws
+		uint64_t seed = 42;
+		printf("DNB_STATIC const uint64_t zobrist_%dx%d[%d] = {", rows, cols, w_max);
+		for(int w=0; w<w_max; ++w)
+			printf("0x%016llxULL%s", (unsigned long long) splitmix64(&seed), w+1 < w_max ? ", " : "");
+		printf("};\n\n");
+
+		cleanup(&board);
+	}
+
+	printf("/* zobrist keys for a rows x cols board, or null if the size has no tables */\n");
+	printf("DNB_STATIC const uint64_t* kernel_zobrist(int rows, int cols){\n");
+	for(int k=0; k<N_SIZES; ++k)
+		printf("\tif(rows == %d && cols == %d) return zobrist_%dx%d;\n", sizes[k][0], sizes[k][1], sizes[k][0], sizes[k][1]);
+	printf("\treturn NULL;\n}\n");
+	return 0;
+}
@@ -0,0 +1,52 @@
+# draws the write-up's charts from a solver_bench csv run:
+#   python3 plot_bench.py bench.csv
+# one line per solver variant against the number of walls on the board, log scale throughout.
+# writes "exec time.jpg", "branches.jpg", "Pruning Factor.jpg" and "hashtable size.jpg"
+import csv
+import sys
+from collections import defaultdict
+
+import matplotlib
+matplotlib.use("Agg")
+import matplotlib.pyplot as plt
+
+def walls(row):
+    r, c = int(row["rows"]), int(row["cols"])
+    return 2*r*c + r + c
+
+def load(path):
+    series = defaultdict(list)
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            series[row["variant"]].append(row)
+    for rows in series.values():
+        rows.sort(key=walls)
+    return series
+
+def chart(series, column, ylabel, filename, skip_zero=False):
+    plt.figure(figsize=(8, 5))
+    for variant, rows in sorted(series.items()):
+        points = [(walls(r), float(r[column])) for r in rows]
+        if skip_zero:
+            points = [p for p in points if p[1] > 0]
+        if not points:
+            continue
+        xs, ys = zip(*points)
+        plt.plot(xs, ys, marker="o", label=variant)
+    plt.yscale("log")
+    plt.xlabel("walls")
+    plt.ylabel(ylabel)
+    plt.legend(fontsize="small")
+    plt.grid(True, which="both", alpha=0.3)
+    plt.tight_layout()
+    plt.savefig(filename)
+    plt.close()
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit("usage: plot_bench.py bench.csv")
+    series = load(sys.argv[1])
+    chart(series, "median_ms", "median time (ms)", "exec time.jpg")
+    chart(series, "nodes", "turns taken", "branches.jpg")
+    chart(series, "pruning_factor", "full game tree / turns taken", "Pruning Factor.jpg")
+    chart(series, "memo_entries", "hashtable entries", "hashtable size.jpg", skip_zero=True)
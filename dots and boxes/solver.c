@@ -0,0 +1,75 @@
+#include "dotsnboxes_variants.h"
+#include "dotsnboxes_db.h"
+
+/* exact solver. usage: solver [variant [generic] [all]], with "rows cols [guess]" on stdin, where
+	the optional guess is the expected margin (e.g. from an earlier solve of a similar board) that
+	alpha-beta variants centre their first window on. "solver list" prints the variants; "generic"
+	skips the fixed-size kernel for boards that have one; "all" also ranks every first turn by its
+	exact value (analyze_moves()). DNB_BOOK=file in the environment looks positions up in an
+	opening book (solver_book) before searching them. */
+int main(int argc, char** argv){
+	const char* name = argc > 1 ? argv[1] : "ab_sym_memo_order";
+	bool generic = false, all = false;
+	for(int a=2; a<argc; ++a){
+		generic = generic || strcmp(argv[a], "generic") == 0;
+		all = all || strcmp(argv[a], "all") == 0;
+	}
+	if(find_variant(name, 0, 0, true) == NULL){
+		if(strcmp(name, "list") != 0) fprintf(stderr, "unknown variant '%s'. one of:\n", name);
+		for(int v=0; v<N_VARIANTS; ++v)
+			if(variants[v].rows == 0) printf("%s\n", variants[v].name);
+		return strcmp(name, "list") == 0 ? 0 : 1;
+	}
+
+	board_t board;
+	stdin_to_board(&board);
+	if(n_walls(&board) > MAX_UID_WALLS){
+		fprintf(stderr, "%d walls is too many for an exact solve (at most %d)\n", n_walls(&board), MAX_UID_WALLS);
+		cleanup(&board);
+		return 1;
+	}
+	variant_t* variant = find_variant(name, board.rows, board.cols, generic);
+
+	int guess;
+	if(scanf("%d", &guess) != 1) guess = predict_margin(&board);
+
+	book_t book;
+	const char* book_path = getenv("DNB_BOOK");
+	if(book_path != NULL){
+		const char* error = book_open(&book, book_path);
+		if(error == NULL && (book.rows != board.rows || book.cols != board.cols)) error = "for another board size";
+		if(error != NULL) fprintf(stderr, "%s: %s, solving without it\n", book_path, error);
+		else board.book = &book;
+	}
+
+	search_t search;
+	search_init(&search, &board);
+	TRACE(search.trace = trace_from_env(&board);)
+	progress_from_env(&search, name);
+	int best_outcome;
+	turn_t* best_turn;
+	move_value_t moves[MAX_UID_WALLS];
+	int n_moves = 0;
+	if(all){
+		n_moves = analyze_moves(&search, variant, guess, moves);
+		best_turn = moves[0].turn;
+		best_outcome = moves[0].value;
+	} else{
+		best_turn = variant->solve(&search, guess, &best_outcome);
+	}
+	PERF(perf_phase(&search.perf, PHASE_OTHER); perf_close(&search.perf);)
+	progress_stop(search.progress, best_outcome);
+
+	stats(&board, best_turn, best_outcome, search.turn_count);
+	if(all) printf("every option:\n");
+	for(int k=0; k<n_moves; ++k)
+		printf("%d %d %s: %d (%ld turns)\n", moves[k].turn->row, moves[k].turn->col, wall_name(moves[k].turn->wall),
+			moves[k].value, moves[k].turns);
+	COUNT(print_counters(&search.counters, &board, search.memo_probes, search.memo_hits, search.memo_stored);)
+	PERF(print_perf(&search.perf);)
+
+	cleanup(&board);
+	if(board.book != NULL) book_close(&book);
+
+	return 0;
+}
@@ -0,0 +1,140 @@
+// clock_gettime()
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "dnb.h"
+
+/* solves a stream of positions, one per line, with one solver context (dnb.h) for all of them,
+	so that nothing is set up twice and the table stays warm from one position to the next.
+	usage: solver_batch [-f file] [-j threads] [-t turns] [-m ms] [-a] [-B book]... [variant], reading
+	stdin without -f. -B looks positions up in an opening book (solver_book) before solving them.
+
+	each line is a position in the text form of dnb.h ("rows cols walls score0 score1 player", or
+	just "rows cols"); blank lines and lines starting with '#' are skipped. for each position one
+	line comes out, in the same order:
+
+		position status value best turns ms [index:value...]
+
+	with the position as parsed, status "ok", "limit" (-t turns or -m ms per position ran out) or
+	an error, the final margin for the player to move, the wall index of a best turn (-1 once the
+	game is over), and with -a the value of every legal turn. value and best are "-" unless ok.
+	a summary goes to stderr.
+
+	with -j (0 for one thread per core), positions are read in chunks and solved in parallel
+	(dnb_solve_batch()), biggest first, with one table per board size shared by all the threads;
+	the output is still in input order. -a then analyses the turns of each position one after the
+	other, once the chunk is solved. */
+
+double batch_ms(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// positions read (and solved in parallel) at a time with -j
+#define BATCH_CHUNK 4096
+
+/* one input line's result line. position and result are null for a line that does not parse */
+void print_result(const char* text, const dnb_position_t* position, int status, const dnb_result_t* result,
+	const dnb_result_t* moves, int n){
+	char buf[128];
+	if(position == NULL){
+		printf("%s unparsable - - 0 0.0\n", text);
+		return;
+	}
+	dnb_format_position(position, buf, sizeof(buf));
+	if(status == DNB_LIMIT) printf("%s limit - - %ld %.1f\n", buf, result->turns, result->ms);
+	else if(status != DNB_OK) printf("%s %s - - 0 0.0\n", buf, status == DNB_INVALID ? "invalid" :
+		(status == DNB_TOO_BIG ? "too_big" : "unknown_variant"));
+	else{
+		printf("%s ok %d %d %ld %.1f", buf, result->value, result->best.index, result->turns, result->ms);
+		for(int k=0; k<n; ++k) printf(" %d:%d", moves[k].best.index, moves[k].value);
+		printf("\n");
+	}
+}
+
+int main(int argc, char** argv){
+	const char* path = NULL;
+	dnb_limits_t limits = {NULL, 0, 0};
+	int analyze = 0, threads = 1, n_books = 0;
+	const char* books[4];
+	for(int a=1; a<argc; ++a){
+		if(strcmp(argv[a], "-f") == 0 && a+1 < argc) path = argv[++a];
+		else if(strcmp(argv[a], "-t") == 0 && a+1 < argc) limits.max_turns = atol(argv[++a]);
+		else if(strcmp(argv[a], "-m") == 0 && a+1 < argc) limits.max_ms = atof(argv[++a]);
+		else if(strcmp(argv[a], "-j") == 0 && a+1 < argc) threads = atoi(argv[++a]);
+		else if(strcmp(argv[a], "-a") == 0) analyze = 1;
+		else if(strcmp(argv[a], "-B") == 0 && a+1 < argc && n_books < 4) books[n_books++] = argv[++a];
+		else if(argv[a][0] != '-' && limits.variant == NULL) limits.variant = argv[a];
+		else{
+			fprintf(stderr, "usage: %s [-f file] [-j threads] [-t turns] [-m ms] [-a] [-B book]... [variant]\n", argv[0]);
+			return 2;
+		}
+	}
+	FILE* in = path != NULL ? fopen(path, "r") : stdin;
+	if(in == NULL){
+		fprintf(stderr, "cannot read %s\n", path);
+		return 1;
+	}
+
+	dnb_solver_t* solver = dnb_create();
+	dnb_set_threads(solver, threads);
+	for(int b=0; b<n_books; ++b){
+		if(dnb_add_book(solver, books[b]) != DNB_OK){
+			fprintf(stderr, "cannot read the book %s\n", books[b]);
+			dnb_free(solver);
+			return 1;
+		}
+	}
+	// one line at a time without threads, so that results come out as soon as they are known
+	int chunk = threads == 1 ? 1 : BATCH_CHUNK;
+	char (*texts)[128] = malloc(sizeof(*texts) * chunk);
+	int* parsed = (int*) malloc(sizeof(int) * chunk); // index in 'positions', -1 for none
+	dnb_position_t* positions = (dnb_position_t*) malloc(sizeof(dnb_position_t) * chunk);
+	dnb_result_t* results = (dnb_result_t*) malloc(sizeof(dnb_result_t) * chunk);
+	int* status = (int*) malloc(sizeof(int) * chunk);
+	dnb_result_t moves[64];
+	long int lines = 0, solved = 0, turns = 0;
+	double start = batch_ms();
+	char line[256];
+	bool more = true;
+	while(more){
+		int n_lines = 0, n_positions = 0;
+		while(n_lines < chunk && (more = fgets(line, sizeof(line), in) != NULL)){
+			char* text = line + strspn(line, " \t");
+			if(*text == '#' || *text == '\n' || *text == '\r' || *text == '\0') continue;
+			text[strcspn(text, "\r\n")] = '\0';
+			snprintf(texts[n_lines], sizeof(texts[n_lines]), "%s", text);
+			parsed[n_lines] = dnb_parse_position(text, &positions[n_positions]) == DNB_OK ? n_positions++ : -1;
+			++n_lines;
+		}
+		dnb_solve_batch(solver, positions, n_positions, &limits, results, status);
+		for(int l=0; l<n_lines; ++l){
+			int p = parsed[l];
+			int n = 0;
+			if(p >= 0 && status[p] == DNB_OK && analyze)
+				status[p] = dnb_analyze_all_moves(solver, &positions[p], &limits, moves, 64, &n);
+			if(p < 0) print_result(texts[l], NULL, DNB_INVALID, NULL, moves, n);
+			else print_result(texts[l], &positions[p], status[p], &results[p], moves, n);
+			if(p >= 0 && (status[p] == DNB_OK || status[p] == DNB_LIMIT)) turns += results[p].turns;
+			for(int k=0; k<n; ++k) turns += moves[k].turns;
+			solved += p >= 0 && status[p] == DNB_OK;
+		}
+		lines += n_lines;
+		fflush(stdout);
+	}
+	double ms = batch_ms() - start;
+	fprintf(stderr, "%ld positions (%ld solved) in %.1f ms, %.1f per second, %.3g turns\n", lines, solved, ms,
+		ms > 0 ? lines / (ms / 1e3) : 0, (double) turns);
+	dnb_free(solver);
+	free(texts);
+	free(parsed);
+	free(positions);
+	free(results);
+	free(status);
+	if(in != stdin) fclose(in);
+	return 0;
+}
@@ -0,0 +1,202 @@
+#include "dotsnboxes_variants.h"
+
+/* benchmark harness for the exact solvers.
+	usage: solver_bench [-r reps] [-w warmup] [-f csv|json] [-b baseline.csv] [-t tolerance]
+	                    [variant RxC ...]
+	runs every case (the default suite, or the variant/size pairs given) 'warmup' times unmeasured
+	and 'reps' times measured, each on a fresh board and table, and writes one record per case to
+	stdout. progress goes to stderr. with a baseline (an earlier csv run), cases whose fastest run
+	is more than 'tolerance' (a fraction) slower than the baseline median, or whose node count
+	changed, are flagged and the exit status is 1. plot_bench.py draws the write-up's charts from the csv.
+	built with "make perf", each record also has the hardware counters of the last run by search
+	phase (see dotsnboxes_perf.h), as "<phase>_<event>" columns after the usual ones. */
+
+typedef struct Case{
+	const char* variant;
+	int rows, cols;
+} case_t;
+
+/* every variant on the sizes it solves in well under a second or two */
+case_t suite[] = {
+	{"brute", 1, 1}, {"brute", 1, 2}, {"brute", 1, 3},
+	{"brute_sym", 1, 1}, {"brute_sym", 1, 2}, {"brute_sym", 1, 3},
+	{"brute_memo", 1, 1}, {"brute_memo", 1, 2}, {"brute_memo", 2, 2}, {"brute_memo", 1, 4},
+	{"sym_memo", 1, 1}, {"sym_memo", 1, 2}, {"sym_memo", 2, 2}, {"sym_memo", 1, 4},
+	{"ab", 1, 1}, {"ab", 1, 2}, {"ab", 2, 2}, {"ab", 1, 4},
+	{"ab_sym", 1, 1}, {"ab_sym", 1, 2}, {"ab_sym", 2, 2}, {"ab_sym", 1, 4},
+	{"ab_order", 1, 1}, {"ab_order", 1, 2}, {"ab_order", 2, 2}, {"ab_order", 1, 4},
+	{"ab_sym_order", 1, 1}, {"ab_sym_order", 1, 2}, {"ab_sym_order", 2, 2}, {"ab_sym_order", 1, 4},
+	{"ab_memo", 1, 1}, {"ab_memo", 1, 2}, {"ab_memo", 2, 2}, {"ab_memo", 2, 3},
+	{"ab_sym_memo", 1, 1}, {"ab_sym_memo", 1, 2}, {"ab_sym_memo", 2, 2}, {"ab_sym_memo", 2, 3},
+	{"ab_memo_order", 1, 1}, {"ab_memo_order", 1, 2}, {"ab_memo_order", 2, 2}, {"ab_memo_order", 2, 3}, {"ab_memo_order", 3, 3},
+	{"ab_sym_memo_order", 1, 1}, {"ab_sym_memo_order", 1, 2}, {"ab_sym_memo_order", 2, 2}, {"ab_sym_memo_order", 2, 3}, {"ab_sym_memo_order", 3, 3},
+};
+#define N_SUITE (int)(sizeof(suite) / sizeof(suite[0]))
+
+typedef struct Result{
+	case_t c;
+	int reps;
+	double median_ms, min_ms, max_ms;
+	long int nodes; // turn_count of one run (the search is deterministic)
+	long int memo_probes, memo_hits, memo_entries;
+	int value;
+	double branches; // size of the full game tree, as in stats()
+	PERF(perf_t perf;) // hardware counters by phase, of the last run
+} result_t;
+
+int by_time(const void* a, const void* b){
+	double d = *(const double*) a - *(const double*) b;
+	return d > 0 ? 1 : (d < 0 ? -1 : 0);
+}
+
+void run_case(case_t c, int reps, int warmup, result_t* r){
+	double times[reps];
+	r->c = c;
+	r->reps = reps;
+	for(int k=-warmup; k<reps; ++k){
+		board_t board;
+		init_board(&board, c.rows, c.cols);
+		variant_t* variant = find_variant(c.variant, c.rows, c.cols, false);
+		search_t search;
+		search_init(&search, &board);
+		double start = now_ms();
+		variant->solve(&search, predict_margin(&board), &r->value);
+		double elapsed = now_ms() - start;
+		PERF(perf_phase(&search.perf, PHASE_OTHER); perf_close(&search.perf); r->perf = search.perf;)
+		if(k >= 0) times[k] = elapsed;
+		r->nodes = search.turn_count;
+		r->memo_probes = search.memo_probes;
+		r->memo_hits = search.memo_hits;
+		r->memo_entries = memo_entries(&board);
+		cleanup(&board);
+	}
+	qsort(times, reps, sizeof(double), by_time);
+	r->median_ms = reps % 2 ? times[reps/2] : (times[reps/2 - 1] + times[reps/2]) / 2;
+	r->min_ms = times[0];
+	r->max_ms = times[reps-1];
+	// sum over k of W!/(W-k)!: every sequence of k distinct walls
+	int w = 2*c.rows*c.cols + c.rows + c.cols;
+	double fact = 1;
+	r->branches = 0;
+	for(int i=w; i>0; --i){ fact *= i; r->branches += fact; }
+}
+
+double spread(result_t* r){
+	return r->median_ms > 0 ? (r->max_ms - r->min_ms) / r->median_ms : 0;
+}
+
+double nps(result_t* r){
+	return r->median_ms > 0 ? r->nodes / (r->median_ms / 1e3) : 0;
+}
+
+double hit_rate(result_t* r){
+	return r->memo_probes > 0 ? (double) r->memo_hits / r->memo_probes : 0;
+}
+
+void print_csv(result_t* results, int n){
+	printf("variant,rows,cols,reps,median_ms,min_ms,max_ms,spread,nodes,nps,memo_probes,memo_hits,hit_rate,pruning_factor,memo_entries,value");
+	PERF(perf_csv_header();)
+	printf("\n");
+	for(int k=0; k<n; ++k){
+		result_t* r = &results[k];
+		printf("%s,%d,%d,%d,%.3f,%.3f,%.3f,%.4f,%ld,%.0f,%ld,%ld,%.4f,%.6g,%ld,%d", r->c.variant, r->c.rows, r->c.cols, r->reps,
+			r->median_ms, r->min_ms, r->max_ms, spread(r), r->nodes, nps(r), r->memo_probes, r->memo_hits, hit_rate(r),
+			r->branches / r->nodes, r->memo_entries, r->value);
+		PERF(perf_csv_values(&r->perf);)
+		printf("\n");
+	}
+}
+
+void print_json(result_t* results, int n){
+	printf("[\n");
+	for(int k=0; k<n; ++k){
+		result_t* r = &results[k];
+		printf("  {\"variant\": \"%s\", \"rows\": %d, \"cols\": %d, \"reps\": %d, \"median_ms\": %.3f, \"min_ms\": %.3f, "
+			"\"max_ms\": %.3f, \"spread\": %.4f, \"nodes\": %ld, \"nps\": %.0f, \"memo_probes\": %ld, \"memo_hits\": %ld, "
+			"\"hit_rate\": %.4f, \"pruning_factor\": %.6g, \"memo_entries\": %ld, \"value\": %d", r->c.variant, r->c.rows,
+			r->c.cols, r->reps, r->median_ms, r->min_ms, r->max_ms, spread(r), r->nodes, nps(r), r->memo_probes, r->memo_hits,
+			hit_rate(r), r->branches / r->nodes, r->memo_entries, r->value);
+		PERF(perf_json_values(&r->perf);)
+		printf("}%s\n", k+1 < n ? "," : "");
+	}
+	printf("]\n");
+}
+
+/* compare against an earlier csv run. returns the number of flagged cases */
+int check_baseline(const char* path, result_t* results, int n, double tolerance){
+	FILE* f = fopen(path, "r");
+	if(f == NULL){
+		fprintf(stderr, "cannot read baseline %s\n", path);
+		return 1;
+	}
+	int flagged = 0;
+	char line[512], name[64];
+	int rows, cols;
+	double median;
+	long int nodes;
+	while(fgets(line, sizeof(line), f) != NULL){
+		if(sscanf(line, "%63[^,],%d,%d,%*d,%lf,%*f,%*f,%*f,%ld", name, &rows, &cols, &median, &nodes) != 5) continue;
+		for(int k=0; k<n; ++k){
+			result_t* r = &results[k];
+			if(strcmp(r->c.variant, name) != 0 || r->c.rows != rows || r->c.cols != cols) continue;
+			if(r->nodes != nodes){
+				fprintf(stderr, "CHANGED %s %dx%d: %ld nodes, baseline %ld\n", name, rows, cols, r->nodes, nodes);
+				flagged++;
+			}
+			// only flag it if even the fastest run is slow, and never below a millisecond, where
+			// timer and scheduler noise swamp any real difference
+			if(r->min_ms > median * (1 + tolerance) && r->min_ms - median > 1.0){
+				fprintf(stderr, "SLOWER %s %dx%d: %.3f ms, baseline %.3f ms (+%.0f%%)\n", name, rows, cols, r->min_ms, median,
+					100 * (r->min_ms / median - 1));
+				flagged++;
+			}
+		}
+	}
+	fclose(f);
+	return flagged;
+}
+
+int main(int argc, char** argv){
+	int reps = 5, warmup = 1;
+	const char* format = "csv";
+	const char* baseline = NULL;
+	double tolerance = 0.25;
+	case_t cases[argc > 1 ? argc : 1];
+	int n = 0;
+	for(int a=1; a<argc; ++a){
+		if(strcmp(argv[a], "-r") == 0 && a+1 < argc) reps = atoi(argv[++a]);
+		else if(strcmp(argv[a], "-w") == 0 && a+1 < argc) warmup = atoi(argv[++a]);
+		else if(strcmp(argv[a], "-f") == 0 && a+1 < argc) format = argv[++a];
+		else if(strcmp(argv[a], "-b") == 0 && a+1 < argc) baseline = argv[++a];
+		else if(strcmp(argv[a], "-t") == 0 && a+1 < argc) tolerance = atof(argv[++a]);
+		else if(a+1 < argc && sscanf(argv[a+1], "%dx%d", &cases[n].rows, &cases[n].cols) == 2){
+			cases[n].variant = argv[a];
+			if(find_variant(cases[n].variant, 0, 0, true) == NULL){
+				fprintf(stderr, "unknown variant '%s'\n", argv[a]);
+				return 2;
+			}
+			n++;
+			a++;
+		} else{
+			fprintf(stderr, "usage: %s [-r reps] [-w warmup] [-f csv|json] [-b baseline.csv] [-t tolerance] [variant RxC ...]\n", argv[0]);
+			return 2;
+		}
+	}
+	if(reps < 1) reps = 1;
+	case_t* todo = n > 0 ? cases : suite;
+	if(n == 0) n = N_SUITE;
+
+	result_t* results = (result_t*) malloc(sizeof(result_t) * n);
+	for(int k=0; k<n; ++k){
+		run_case(todo[k], reps, warmup, &results[k]);
+		fprintf(stderr, "%-18s %dx%d  %10.3f ms  (+-%4.1f%%)  %12ld nodes  %6.2f Mnps\n", todo[k].variant, todo[k].rows,
+			todo[k].cols, results[k].median_ms, 50 * spread(&results[k]), results[k].nodes, nps(&results[k]) / 1e6);
+	}
+
+	if(strcmp(format, "json") == 0) print_json(results, n);
+	else print_csv(results, n);
+
+	int flagged = baseline != NULL ? check_baseline(baseline, results, n, tolerance) : 0;
+	free(results);
+	return flagged > 0 ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+#include "dotsnboxes_variants.h"
+#include "dotsnboxes_db.h"
+
+/* builds an opening book (dotsnboxes_db.h) for solver, solver_session and solver_server to look up
+	before they search: the first few turns are the slowest to solve and the same in every game.
+	usage: solver_book [-p plies] [variant [generic]] file, with "rows cols" on stdin.
+	solves every position after up to 'plies' turns (default 2) exactly, once for all of its
+	symmetric images, deepest first so that the shallower ones find them in the table. */
+
+int by_book_depth(const void* a, const void* b){
+	int x = __builtin_popcountll(((const book_position_t*) a)->uid), y = __builtin_popcountll(((const book_position_t*) b)->uid);
+	return y - x;
+}
+
+int main(int argc, char** argv){
+	const char* name = "ab_sym_memo_order";
+	const char* path = NULL;
+	bool generic = false;
+	int plies = 2;
+	for(int a=1; a<argc; ++a){
+		if(strcmp(argv[a], "-p") == 0 && a+1 < argc) plies = atoi(argv[++a]);
+		else if(strcmp(argv[a], "generic") == 0) generic = true;
+		else if(argv[a][0] != '-' && find_variant(argv[a], 0, 0, true) != NULL) name = argv[a];
+		else if(argv[a][0] != '-' && path == NULL) path = argv[a];
+		else path = NULL, a = argc;
+	}
+	if(path == NULL || plies < 0){
+		fprintf(stderr, "usage: %s [-p plies] [variant [generic]] file\n", argv[0]);
+		return 2;
+	}
+
+	board_t board;
+	stdin_to_board(&board);
+	if(n_walls(&board) > MAX_UID_WALLS || plies >= n_walls(&board)){
+		fprintf(stderr, "%d walls: too many for an exact solve, or not more than %d plies\n", n_walls(&board), plies);
+		cleanup(&board);
+		return 1;
+	}
+	variant_t* variant = find_variant(name, board.rows, board.cols, generic);
+	search_t search;
+	search_init(&search, &board);
+
+	// the positions, once each
+	book_positions_t positions = {NULL, 0, 0};
+	book_collect(&board, plies, &positions);
+	long int reached = positions.n;
+	long int n = book_unique(&positions);
+	qsort(positions.at, n, sizeof(book_position_t), by_book_depth);
+
+	double start = now_ms();
+	bid_t* uids = (bid_t*) malloc(sizeof(bid_t) * n);
+	book_move_t* moves = (book_move_t*) malloc(sizeof(book_move_t) * n);
+	for(long int i=0; i<n; ++i){
+		book_position_t* p = &positions.at[i];
+		set_position(&board, p->uid, p->scores[0], p->scores[1], p->player);
+		int value;
+		turn_t* best = variant->solve(&search, predict_margin(&board), &value);
+		// the table's swing, i.e. without the boxes already taken
+		p->value = value - (p->scores[p->player] - p->scores[1 - p->player]);
+		p->best = best->index;
+	}
+	double ms = now_ms() - start;
+	qsort(positions.at, n, sizeof(book_position_t), by_book_uid);
+	for(long int i=0; i<n; ++i){
+		uids[i] = positions.at[i].uid;
+		moves[i].value = (int8_t) positions.at[i].value;
+		moves[i].best_move = (uint8_t) positions.at[i].best;
+	}
+	bool ok = book_write(board.rows, board.cols, plies, uids, moves, n, path);
+	if(ok) printf("%ld positions (%ld lines of play) to %d plies, solved in %.1f ms, %ld turns: %s, %ld bytes\n", n, reached,
+		plies, ms, search.turn_count, path, (long int) (sizeof(book_header_t) + n * (sizeof(bid_t) + sizeof(book_move_t))));
+	else fprintf(stderr, "cannot write %s\n", path);
+	free(uids);
+	free(moves);
+	free(positions.at);
+	PERF(perf_close(&search.perf);)
+	cleanup(&board);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include "dotsnboxes_variants.h"
+#include "dotsnboxes_session.h"
+
+/* builds a table of solved positions (dotsnboxes_db.h) for solver_session and solver_server to
+	look up, so that what is the same in every game is solved once, offline, and shared.
+	usage: solver_db [-w walls] [-b bits] [variant [generic]] file, with positions on stdin, one
+	per line in the text form of position_t ("rows cols" for the start of a game), all of one size.
+	solves them all into one table and writes out every entry for positions with at most 'walls'
+	walls drawn (default all of them): the fewer, the smaller the file, but lookups then stop
+	higher up in the tree. */
+
+int main(int argc, char** argv){
+	session_t s;
+	session_init(&s);
+	const char* path = NULL;
+	int max_walls = MAX_UID_WALLS;
+	for(int a=1; a<argc; ++a){
+		if(strcmp(argv[a], "-w") == 0 && a+1 < argc) max_walls = atoi(argv[++a]);
+		else if(strcmp(argv[a], "-b") == 0 && a+1 < argc) s.memo_bits = atoi(argv[++a]);
+		else if(strcmp(argv[a], "generic") == 0) s.generic = true;
+		else if(argv[a][0] != '-' && find_variant(argv[a], 0, 0, true) != NULL) s.name = argv[a];
+		else if(argv[a][0] != '-' && path == NULL) path = argv[a];
+		else path = NULL, a = argc;
+	}
+	if(path == NULL || s.memo_bits < 0 || s.memo_bits > 40){
+		fprintf(stderr, "usage: %s [-w walls] [-b bits] [variant [generic]] file\n", argv[0]);
+		return 2;
+	}
+
+	char line[256];
+	long int turns = 0;
+	int solved = 0;
+	double start = now_ms();
+	while(fgets(line, sizeof(line), stdin) != NULL){
+		char* text = line + strspn(line, " \t");
+		if(*text == '#' || *text == '\n' || *text == '\r' || *text == '\0') continue;
+		text[strcspn(text, "\r\n")] = '\0';
+		position_t p;
+		const char* error = parse_position(text, &p) ? NULL : "cannot parse the position";
+		if(error == NULL && s.has_board && (p.rows != s.board.rows || p.cols != s.board.cols)) error = "not the size of the others";
+		if(error == NULL) error = session_set(&s, &p);
+		if(error != NULL){
+			fprintf(stderr, "%s: %s\n", text, error);
+			session_free(&s);
+			return 1;
+		}
+		if(game_is_over(&s.board)) continue;
+		int value;
+		s.search.turn_count = 0;
+		s.variant->solve(&s.search, predict_margin(&s.board), &value);
+		turns += s.search.turn_count;
+		++solved;
+	}
+	if(!s.has_board){
+		fprintf(stderr, "no positions\n");
+		return 1;
+	}
+	if(s.board.memo_hashtable == NULL) init_memo(&s.board);
+	bool ok = db_write(&s.board, max_walls, path);
+	if(ok){
+		solved_db_t db;
+		ok = db_open(&db, path) == NULL;
+		if(ok) printf("%d positions solved in %.1f ms, %ld turns: %s, %dx%d, %ld entries in %ld slots, up to %d walls\n",
+			solved, now_ms() - start, turns, path, db.rows, db.cols, db.entries, 1L << db.bits, db.max_walls);
+		db_close(&db);
+	}
+	if(!ok) fprintf(stderr, "cannot write %s\n", path);
+	session_free(&s);
+	return ok ? 0 : 1;
+}
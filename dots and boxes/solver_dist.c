@@ -0,0 +1,331 @@
+#include "dotsnboxes_variants.h"
+#include "dotsnboxes_session.h"
+#include <dirent.h>
+#include <errno.h>
+#include <sys/types.h>
+
+/* one exact solve spread over many processes, on this host or any that share the directory.
+	usage: solver_dist [-p plies] [-l lease_s] [variant [generic]] coordinate dir, with "rows cols"
+	           on stdin
+	       solver_dist [-b bits] [-M mb] [-d file]... [-B file]... [variant [generic]] work dir
+
+	the coordinator splits the tree 'plies' turns (default 1) below the root into units, one for
+	all the symmetric images of each position there, and queues them as files in the directory;
+	each worker takes units one at a time, solves them with a table it keeps from one unit to the
+	next (dropping what the last two units did not use once it passes -M mb, default 2048, as in
+	solver_session), and hands in the result. once every unit is in, the coordinator writes them
+	out as an opening book (dir/units.book) and solves the root on top of it, which only searches
+	the top 'plies' turns. start any number of workers, before or after the coordinator.
+
+	every unit is solved exactly, without the bounds its siblings would give it in one search, so
+	the split costs more turns in all than a single solve, and more the deeper it goes. on 3x3
+	(3.07M turns alone): -p 1 is 4 units and 3.8M turns with one worker (5.0M with two, whose tables
+	are separate), the biggest unit 1.3M, so that four workers finish in well under half the time
+	of one solve; -p 2 is 43 units and 13M turns, -p 3 264 units and 20M turns, which only pay off
+	with many more workers than units at -p 1, on boards too big to solve in one piece.
+
+	the queue is nothing but files, renamed from one state to the next (rename() is atomic, so
+	only one worker gets each unit):
+		dir/todo/N      unit N, a position in the text form of position_t
+		dir/taken/N     taken by a worker, which touches it every second while it works
+		dir/done/N      "value best turns ms": the final margin for the player to move, and the
+		                wall_index() of a best turn
+		dir/finished    every unit is done; the workers leave
+	a unit taken and not touched for 'lease_s' seconds (default 30) was taken by a worker that
+	died, and goes back in todo/. a unit solved twice (by a worker presumed dead that was only
+	slow) gets the same value twice. results already in done/ when the coordinator starts, from an
+	earlier run of the same split, are kept. another transport, e.g. over the network, only needs
+	to move these files. */
+
+#define DIST_PATH 4096
+#define DIST_DBS 8
+
+typedef struct Dist{
+	const char* dir;
+	char path[DIST_PATH];
+} dist_t;
+
+/* dir/state/N into d->path */
+const char* dist_path(dist_t* d, const char* state, long int unit){
+	if(unit >= 0) snprintf(d->path, DIST_PATH, "%s/%s/%ld", d->dir, state, unit);
+	else snprintf(d->path, DIST_PATH, "%s/%s", d->dir, state);
+	return d->path;
+}
+
+bool dist_exists(const char* path){
+	struct stat st;
+	return stat(path, &st) == 0;
+}
+
+void dist_sleep(double ms){
+	struct timespec ts = {(time_t) (ms / 1e3), (long int) ((ms - 1e3 * (long int) (ms / 1e3)) * 1e6)};
+	nanosleep(&ts, NULL);
+}
+
+/* the units in dir/state, as numbers, into 'units' (room for 'max'). how many there are */
+long int dist_list(dist_t* d, const char* state, long int* units, long int max){
+	DIR* dir = opendir(dist_path(d, state, -1));
+	if(dir == NULL) return 0;
+	long int n = 0;
+	for(struct dirent* e; (e = readdir(dir)) != NULL && n < max; ){
+		char* end;
+		long int unit = strtol(e->d_name, &end, 10);
+		if(end != e->d_name && *end == '\0') units[n++] = unit;
+	}
+	closedir(dir);
+	return n;
+}
+
+/* 'text' into the file at 'path', whole or not at all */
+bool dist_write(const char* path, const char* text){
+	char temp[DIST_PATH + 32];
+	snprintf(temp, sizeof(temp), "%s.%ld", path, (long int) getpid());
+	FILE* f = fopen(temp, "w");
+	if(f == NULL) return false;
+	bool ok = fputs(text, f) >= 0;
+	if(fclose(f) != 0) ok = false;
+	if(ok) ok = rename(temp, path) == 0;
+	if(!ok) unlink(temp);
+	return ok;
+}
+
+/* the first line of dir/state/N into 'text' */
+bool dist_read(dist_t* d, const char* state, long int unit, char* text, int size){
+	FILE* f = fopen(dist_path(d, state, unit), "r");
+	if(f == NULL) return false;
+	bool ok = fgets(text, size, f) != NULL;
+	fclose(f);
+	return ok;
+}
+
+/* keeps a taken unit's file fresh while a worker solves it */
+typedef struct Heartbeat{
+	char path[DIST_PATH];
+	pthread_t thread;
+	volatile bool stop;
+} heartbeat_t;
+
+void* heartbeat_thread(void* arg){
+	heartbeat_t* h = (heartbeat_t*) arg;
+	while(!h->stop){
+		utimensat(AT_FDCWD, h->path, NULL, 0);
+		for(int i=0; i<10 && !h->stop; ++i) dist_sleep(100);
+	}
+	return NULL;
+}
+
+int work(dist_t* d, session_t* s){
+	long int units[1024];
+	long int solved = 0, turns = 0;
+	double start = now_ms();
+	while(true){
+		long int n = dist_list(d, "todo", units, 1024);
+		if(n == 0){
+			if(dist_exists(dist_path(d, "finished", -1))) break;
+			dist_sleep(200);
+			continue;
+		}
+		// start somewhere else than the other workers, who see the same list
+		long int first = getpid() % n;
+		for(long int k=0; k<n; ++k){
+			long int unit = units[(first + k) % n];
+			char todo[DIST_PATH];
+			snprintf(todo, DIST_PATH, "%s", dist_path(d, "todo", unit));
+			heartbeat_t h;
+			h.stop = false;
+			snprintf(h.path, DIST_PATH, "%s", dist_path(d, "taken", unit));
+			if(rename(todo, h.path) != 0) continue;
+			// rename() keeps the time the coordinator wrote it: the lease starts now
+			utimensat(AT_FDCWD, h.path, NULL, 0);
+			char line[256], result[128];
+			position_t p;
+			const char* error = NULL;
+			if(dist_exists(dist_path(d, "done", unit))) error = "";
+			else if(!dist_read(d, "taken", unit, line, sizeof(line)) || !parse_position(line, &p)) error = "cannot read it";
+			else error = session_set(s, &p);
+			if(error != NULL){
+				if(*error) fprintf(stderr, "unit %ld: %s\n", unit, error);
+				unlink(h.path);
+				continue;
+			}
+			bool beating = pthread_create(&h.thread, NULL, heartbeat_thread, &h) == 0;
+			double unit_start = now_ms();
+			int value;
+			s->board.memo_generation++;
+			s->search.turn_count = 0;
+			s->search.memo_stored = 0;
+			turn_t* best = s->variant->solve(&s->search, predict_margin(&s->board), &value);
+			h.stop = true;
+			if(beating) pthread_join(h.thread, NULL);
+			// keep the table in bounds, like a session between moves
+			s->entries += s->search.memo_stored;
+			if(s->entries > s->budget) s->entries -= age_memo(&s->board, s->board.memo_generation - 1);
+			snprintf(result, sizeof(result), "%d %d %ld %.1f\n", value, game_is_over(&s->board) ? -1 : best->index,
+				s->search.turn_count, now_ms() - unit_start);
+			if(!dist_write(dist_path(d, "done", unit), result)) fprintf(stderr, "unit %ld: cannot hand it in\n", unit);
+			unlink(h.path);
+			++solved;
+			turns += s->search.turn_count;
+		}
+	}
+	fprintf(stderr, "worker %ld: %ld units, %ld turns in %.1f ms\n", (long int) getpid(), solved, turns, now_ms() - start);
+	return 0;
+}
+
+int coordinate(dist_t* d, session_t* s, int plies, double lease_s){
+	board_t board;
+	stdin_to_board(&board);
+	if(n_walls(&board) > MAX_UID_WALLS || plies < 1 || plies >= n_walls(&board)){
+		fprintf(stderr, "%d walls: too many for an exact solve, or not more than %d plies\n", n_walls(&board), plies);
+		cleanup(&board);
+		return 1;
+	}
+	// the units, in an order that only depends on the split
+	book_positions_t positions = {NULL, 0, 0};
+	book_collect(&board, plies, &positions);
+	long int n = 0;
+	for(long int i=0; i<positions.n; ++i)
+		if(__builtin_popcountll(positions.at[i].uid) == plies) positions.at[n++] = positions.at[i];
+	positions.n = n;
+	n = book_unique(&positions);
+
+	char job[64], line[256];
+	snprintf(job, sizeof(job), "%d %d %d %ld\n", board.rows, board.cols, plies, n);
+	if(dist_read(d, "job", -1, line, sizeof(line)) && strcmp(line, job) != 0){
+		fprintf(stderr, "%s holds another split (rows cols plies units: %s)\n", d->dir, strtok(line, "\n"));
+		cleanup(&board);
+		free(positions.at);
+		return 1;
+	}
+	unlink(dist_path(d, "finished", -1));
+	mkdir(d->dir, 0777);
+	const char* states[] = {"todo", "taken", "done"};
+	for(int k=0; k<3; ++k) mkdir(dist_path(d, states[k], -1), 0777);
+	bool ok = dist_write(dist_path(d, "job", -1), job);
+	for(long int u=0; u<n && ok; ++u){
+		book_position_t* p = &positions.at[u];
+		position_t position = {board.rows, board.cols, p->uid, {p->scores[0], p->scores[1]}, p->player};
+		format_position(&position, line, sizeof(line));
+		strcat(line, "\n");
+		if(!dist_exists(dist_path(d, "done", u)) && !dist_exists(dist_path(d, "taken", u))) ok = dist_write(dist_path(d, "todo", u), line);
+	}
+	if(!ok){
+		fprintf(stderr, "cannot queue work in %s\n", d->dir);
+		cleanup(&board);
+		free(positions.at);
+		return 1;
+	}
+
+	// wait for the results, putting back what dead workers took
+	double start = now_ms(), reported = 0;
+	long int* units = (long int*) malloc(sizeof(long int) * (n + 1));
+	long int done = 0;
+	while((done = dist_list(d, "done", units, n + 1)) < n){
+		long int taken = dist_list(d, "taken", units, n + 1);
+		time_t now = time(NULL);
+		for(long int k=0; k<taken; ++k){
+			struct stat st;
+			char path[DIST_PATH];
+			snprintf(path, DIST_PATH, "%s", dist_path(d, "taken", units[k]));
+			if(stat(path, &st) == 0 && difftime(now, st.st_mtime) > lease_s && rename(path, dist_path(d, "todo", units[k])) == 0)
+				fprintf(stderr, "unit %ld: lease expired, queued again\n", units[k]);
+		}
+		if(now_ms() - reported >= 1e3){
+			fprintf(stderr, "%ld of %ld units done, %ld being solved, %.0f s\n", done, n, taken, (now_ms() - start) / 1e3);
+			reported = now_ms();
+		}
+		dist_sleep(200);
+	}
+	free(units);
+
+	// the results as a book of the positions 'plies' deep, and the top of the tree on it
+	bid_t* uids = (bid_t*) malloc(sizeof(bid_t) * n);
+	book_move_t* moves = (book_move_t*) malloc(sizeof(book_move_t) * n);
+	long int unit_turns = 0;
+	for(long int u=0; u<n && ok; ++u){
+		book_position_t* p = &positions.at[u];
+		int value, best;
+		long int turns;
+		ok = dist_read(d, "done", u, line, sizeof(line)) && sscanf(line, "%d %d %ld", &value, &best, &turns) == 3 && best >= 0;
+		uids[u] = p->uid;
+		moves[u].value = (int8_t) (value - (p->scores[p->player] - p->scores[1 - p->player]));
+		moves[u].best_move = (uint8_t) best;
+		unit_turns += turns;
+	}
+	snprintf(line, sizeof(line), "%s/units.book", d->dir);
+	book_t book;
+	if(ok) ok = book_write(board.rows, board.cols, plies, uids, moves, n, line) && book_open(&book, line) == NULL;
+	free(uids);
+	free(moves);
+	free(positions.at);
+	if(!ok){
+		fprintf(stderr, "cannot read the results in %s\n", d->dir);
+		cleanup(&board);
+		return 1;
+	}
+	board.book = &book;
+	variant_t* variant = find_variant(s->name, board.rows, board.cols, s->generic);
+	search_t search;
+	search_init(&search, &board);
+	int value;
+	turn_t* best = variant->solve(&search, predict_margin(&board), &value);
+	dist_write(dist_path(d, "finished", -1), "");
+
+	stats(&board, best, value, search.turn_count);
+	printf("%ld units of %d plies, %ld turns in the workers, %.1f ms\n", n, plies, unit_turns, now_ms() - start);
+	PERF(perf_close(&search.perf);)
+	cleanup(&board);
+	book_close(&book);
+	return 0;
+}
+
+int main(int argc, char** argv){
+	session_t s;
+	session_init(&s);
+	int plies = 1;
+	double lease_s = 30, budget_mb = 2048;
+	solved_db_t dbs[DIST_DBS];
+	book_t books[DIST_DBS];
+	const char* mode = NULL;
+	dist_t d = {NULL, ""};
+	for(int a=1; a<argc; ++a){
+		if(strcmp(argv[a], "-p") == 0 && a+1 < argc) plies = atoi(argv[++a]);
+		else if(strcmp(argv[a], "-l") == 0 && a+1 < argc) lease_s = atof(argv[++a]);
+		else if(strcmp(argv[a], "-b") == 0 && a+1 < argc) s.memo_bits = atoi(argv[++a]);
+		else if(strcmp(argv[a], "-M") == 0 && a+1 < argc) budget_mb = atof(argv[++a]);
+		else if(strcmp(argv[a], "-d") == 0 && a+1 < argc && s.n_dbs < DIST_DBS){
+			const char* error = db_open(&dbs[s.n_dbs], argv[++a]);
+			if(error != NULL){
+				fprintf(stderr, "%s: %s\n", argv[a], error);
+				return 1;
+			}
+			s.n_dbs++;
+		}
+		else if(strcmp(argv[a], "-B") == 0 && a+1 < argc && s.n_books < DIST_DBS){
+			const char* error = book_open(&books[s.n_books], argv[++a]);
+			if(error != NULL){
+				fprintf(stderr, "%s: %s\n", argv[a], error);
+				return 1;
+			}
+			s.n_books++;
+		}
+		else if(strcmp(argv[a], "generic") == 0) s.generic = true;
+		else if(argv[a][0] != '-' && find_variant(argv[a], 0, 0, true) != NULL) s.name = argv[a];
+		else if(mode == NULL && (strcmp(argv[a], "coordinate") == 0 || strcmp(argv[a], "work") == 0)) mode = argv[a];
+		else if(argv[a][0] != '-' && mode != NULL && d.dir == NULL) d.dir = argv[a];
+		else mode = NULL, a = argc;
+	}
+	if(mode == NULL || d.dir == NULL || lease_s <= 0 || s.memo_bits < 0 || s.memo_bits > 40){
+		fprintf(stderr, "usage: %s [-p plies] [-l lease_s] [variant [generic]] coordinate dir\n"
+			"       %s [-b bits] [-M mb] [-d file]... [-B file]... [variant [generic]] work dir\n", argv[0], argv[0]);
+		return 2;
+	}
+	s.budget = (long int) (budget_mb * 1048576 / sizeof(memo_t));
+	s.dbs = dbs;
+	s.books = books;
+	int status = strcmp(mode, "work") == 0 ? work(&d, &s) : coordinate(&d, &s, plies, lease_s);
+	session_free(&s);
+	for(int i=0; i<s.n_dbs; ++i) db_close(&dbs[i]);
+	for(int i=0; i<s.n_books; ++i) book_close(&books[i]);
+	return status;
+}
@@ -0,0 +1,202 @@
+#include "dotsnboxes_variants.h"
+#include <math.h>
+
+/* estimates how many turns (and how long) an exact solve will take, without running it.
+	usage: solver_estimate [-p probes] [-d split] [-s seed] [variant [generic]], with "rows cols"
+	on stdin, for the same variant names as solver.
+
+	Knuth's estimator, with the real engine at the bottom: each probe walks 'split' random turns
+	down from the root, multiplying the number of children the variant would search at every node
+	on the way, then solves the position it reached with the variant itself and scales its turn
+	count up by that product. The mean over probes estimates the whole search.
+	Above the split, symmetry pruning is exact. Alpha-beta is modelled as a perfectly ordered
+	(minimal) tree: a node that should cut searches only its first turn, in the variant's order;
+	below it, each subtree is solved with a window around the root's expected value, as the real
+	search would. Without a table, that comes to 1.6x the real count on 2x3 (ab_sym, split 6).
+	Memo variants keep one table across the probes, like the real solve. A subtree sampled twice is
+	only solved the first time, and counts what it cost then: each probe stands for a whole search,
+	and a table hit at its root would count that search as next to nothing. The sampled subtrees
+	only share a small part of what the real ones do, so memo variants still come out high: with
+	the default split, about 1.7x on 2x4 and 4-5x on 3x3, and far more with deep splits. So the
+	"sampling error" printed with the estimate is just that, the spread of the probes: the model
+	can be off by more than it. Deeper splits are cheaper per probe and noisier. Split 0, the
+	default for boards of up to 20 walls, is the real solve, done once. */
+
+/* alpha-beta node types of the minimal tree */
+#define NODE_PV 0   // searched with an open window: every child, the first one PV
+#define NODE_CUT 1  // fails high: one child is enough
+#define NODE_ALL 2  // fails low: every child has to be refuted
+
+/* a subtree solved by an earlier probe, and what it cost */
+typedef struct Sampled{
+	bid_t uid;
+	int player;
+	long int turns;
+} sampled_t;
+
+typedef struct Probe{
+	double nodes; // estimated turns for the whole search
+	long int solved; // turns actually taken in the subtree solve
+	double ms; // time of the subtree solve
+} probe_t;
+
+/* whether the policy is part of the variant's name, e.g. "sym" of "ab_sym_memo_order" */
+bool has_policy(const char* name, const char* policy){
+	size_t n = strlen(policy);
+	for(const char* p = name; (p = strstr(p, policy)) != NULL; p += n)
+		if((p == name || p[-1] == '_') && (p[n] == '\0' || p[n] == '_')) return true;
+	return false;
+}
+
+/* the turns a search of this position would try, in its order. returns how many */
+int children(board_t* board, bool sym, bool order, turn_t** out){
+	bool symmetries[MAX_SYMMETRIES];
+	for(int s=1; s<board->n_lists; ++s) symmetries[s] = sym && has_symmetry(board, s);
+	bid_t searched = 0;
+	int n = 0;
+	for(int pass=0; pass<(order ? 3 : 1); ++pass){
+		for(turn_t* t = board->sentinel->next; t != board->sentinel; t = t->next){
+			if(order && turn_priority(t, board) != 2 - pass) continue;
+			bool mirror = false;
+			for(int s=1; s<board->n_lists && !mirror; ++s)
+				mirror = symmetries[s] && t->pairs[s] != NULL && (searched & t->pairs[s]->uid);
+			if(mirror) continue;
+			searched |= t->uid;
+			out[n++] = t;
+		}
+	}
+	return n;
+}
+
+void probe(board_t* board, variant_t* variant, int split, int guess, uint64_t* seed, sampled_t* sampled, int* n_sampled,
+	probe_t* p){
+	bool ab = has_policy(variant->name, "ab");
+	bool sym = has_policy(variant->name, "sym");
+	bool order = has_policy(variant->name, "order");
+	bool memo = has_policy(variant->name, "memo");
+	turn_t* path[MAX_UID_WALLS];
+	turn_t* memos[MAX_UID_WALLS];
+	turn_t* options[MAX_UID_WALLS];
+	int root_player = board->player_turn;
+	double weight = 1;
+	int type = NODE_PV;
+	int depth = 0;
+	p->nodes = 0;
+	p->solved = 0;
+	p->ms = 0;
+	for(; depth < split && !game_is_over(board); ++depth){
+		int n = children(board, sym, order, options);
+		int k = (int) (splitmix64(seed) % n);
+		if(ab && type == NODE_CUT){
+			n = 1;
+			k = 0;
+		}
+		weight *= n;
+		// every turn executed below here, whichever was picked, is a turn the search takes
+		p->nodes += weight;
+		turn_t* t = options[k];
+		int player = board->player_turn;
+		execute_turn(t, board);
+		memos[depth] = remove_turn_dll(t);
+		play_symmetries(t, board);
+		path[depth] = t;
+		// a capture keeps the turn, and with it the direction the node has to fail in
+		bool same = board->player_turn == player;
+		if(type == NODE_PV) type = k == 0 ? NODE_PV : (same ? NODE_ALL : NODE_CUT);
+		else if(type == NODE_CUT) type = same ? NODE_CUT : NODE_ALL;
+		else type = same ? NODE_ALL : NODE_CUT;
+	}
+	int seen = 0;
+	while(seen < *n_sampled && (sampled[seen].uid != board->uid || sampled[seen].player != board->player_turn)) ++seen;
+	if(seen < *n_sampled){
+		p->nodes += weight * sampled[seen].turns;
+	} else if(!game_is_over(board)){
+		search_t search;
+		search_init(&search, board);
+		int value;
+		double start = now_ms();
+		// the real search reaches this position with its window around the root's value
+		variant->solve(&search, board->player_turn == root_player ? guess : -guess, &value);
+		p->ms = now_ms() - start;
+		p->solved = search.turn_count;
+		p->nodes += weight * search.turn_count;
+		sampled[*n_sampled].uid = board->uid;
+		sampled[*n_sampled].player = board->player_turn;
+		sampled[(*n_sampled)++].turns = search.turn_count;
+		if(!memo) free_memo(board);
+	}
+	while(depth-- > 0){
+		unplay_symmetries(path[depth], board);
+		add_turn_dll(memos[depth], path[depth]);
+		unexecute_turn(path[depth], board);
+	}
+}
+
+int main(int argc, char** argv){
+	int probes = 200, split = -1;
+	uint64_t seed = 1;
+	const char* name = "ab_sym_memo_order";
+	bool generic = false;
+	for(int a=1; a<argc; ++a){
+		if(strcmp(argv[a], "-p") == 0 && a+1 < argc) probes = atoi(argv[++a]);
+		else if(strcmp(argv[a], "-d") == 0 && a+1 < argc) split = atoi(argv[++a]);
+		else if(strcmp(argv[a], "-s") == 0 && a+1 < argc) seed = strtoull(argv[++a], NULL, 10);
+		else if(strcmp(argv[a], "generic") == 0) generic = true;
+		else if(argv[a][0] != '-' && find_variant(argv[a], 0, 0, true) != NULL) name = argv[a];
+		else{
+			fprintf(stderr, "usage: %s [-p probes] [-d split] [-s seed] [variant [generic]]\n", argv[0]);
+			return 2;
+		}
+	}
+	if(probes < 1) probes = 1;
+
+	board_t board;
+	stdin_to_board(&board);
+	int walls = n_walls(&board);
+	if(walls > MAX_UID_WALLS){
+		fprintf(stderr, "%d walls is too many for an exact solve (at most %d)\n", walls, MAX_UID_WALLS);
+		cleanup(&board);
+		return 1;
+	}
+	// by default, leave subtrees of about 20 walls to the engine: a few ms each
+	if(split < 0) split = walls > 20 ? walls - 20 : 0;
+	// split 0 is the search itself: there is nothing to sample
+	if(split == 0) probes = 1;
+	variant_t* variant = find_variant(name, board.rows, board.cols, generic);
+	int guess = predict_margin(&board);
+
+	sampled_t* sampled = (sampled_t*) malloc(sizeof(sampled_t) * probes);
+	int n_sampled = 0;
+	double sum = 0, sum_sq = 0, ms = 0;
+	long int solved = 0;
+	for(int k=0; k<probes; ++k){
+		probe_t p;
+		probe(&board, variant, split, guess, &seed, sampled, &n_sampled, &p);
+		sum += p.nodes;
+		sum_sq += p.nodes * p.nodes;
+		solved += p.solved;
+		ms += p.ms;
+	}
+	double mean = sum / probes;
+	double var = probes > 1 ? (sum_sq - probes * mean * mean) / (probes - 1) : 0;
+	// standard error of the mean: the probes' spread, and nothing about the model's bias
+	double error = sqrt(var > 0 ? var : 0) / sqrt(probes);
+	double nps = ms > 0 ? solved / (ms / 1e3) : 0;
+
+	printf("%s, %dx%d, %d walls\n", variant->name, board.rows, board.cols, walls);
+	if(split == 0){
+		printf("split at depth 0: the real solve\n");
+		printf("turns: %.0f\n", mean);
+		printf("time: %.4g s\n", ms / 1e3);
+	} else{
+		printf("%d probes, split at depth %d\n", probes, split);
+		printf("estimated turns: %.4g (sampling error +-%.2g)\n", mean, error);
+		if(nps > 0){
+			printf("measured speed: %.3g turns/s\n", nps);
+			printf("estimated time: %.4g s (sampling error +-%.2g)\n", mean / nps, error / nps);
+		}
+	}
+	free(sampled);
+	cleanup(&board);
+	return 0;
+}
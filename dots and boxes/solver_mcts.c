@@ -0,0 +1,39 @@
+#include "dotsnboxes_mcts.h"
+
+/* Monte Carlo tree search for boards too large to solve exactly.
+	input is "rows cols [ms_per_move [mb [moves]]]". the engine plays against itself for 'moves'
+	moves (default: the whole game), reusing its tree from one move to the next. */
+int main(){
+	board_t board;
+	stdin_to_board(&board);
+
+	long int time_ms = 1000, memory_mb = 256, moves = -1;
+	if(scanf("%ld", &time_ms) == 1 && scanf("%ld", &memory_mb) == 1)
+		if(scanf("%ld", &moves) != 1) moves = -1;
+
+	mcts_t mcts;
+	mcts_init(&mcts, &board, time_ms, memory_mb << 20, 0);
+
+	long int total_leaves = 0, total_playouts = 0;
+	double total_ms = 0;
+	for(long int m=0; !game_is_over(&board) && m != moves; ++m){
+		int player = board.player_turn;
+		int w = mcts_search(&mcts);
+		total_leaves += mcts.leaves;
+		total_playouts += mcts.playouts;
+		total_ms += mcts.elapsed_ms;
+		mcts_stats(&mcts, player, w);
+		mcts_advance(&mcts, w);
+	}
+
+	printf("%d : %d\n", board.scores[0], board.scores[1]);
+	// on bitboards every leaf is played out LANES times
+	double ms = total_ms > 0 ? total_ms : 1;
+	printf("%ld leaves (%.0f/ms), %ld playouts (%.0f/ms) in %.0f ms\n", total_leaves, total_leaves / ms, total_playouts,
+		total_playouts / ms, total_ms);
+
+	mcts_free(&mcts);
+	cleanup(&board);
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+#include "dotsnboxes_mcts.h"
+
+typedef struct Opening{
+	turn_t* turn;
+	double mean;
+	double win_rate;
+} opening_t;
+
+int by_mean(const void* a, const void* b){
+	double d = ((opening_t*) b)->mean - ((opening_t*) a)->mean;
+	return d > 0 ? 1 : (d < 0 ? -1 : 0);
+}
+
+/* playout statistics for every first move.
+	input is "rows cols [playouts_per_move]". means and win rates are for player 0 (who made the
+	first move). */
+int main(){
+	board_t board;
+	stdin_to_board(&board);
+	long int n = 100000;
+	if(scanf("%ld", &n) != 1) n = 100000;
+
+	playout_t playout;
+	init_playout(&playout, &board, 0);
+	bitlayout_t layout;
+	bool bitboard = bitlayout_init(&layout, board.rows, board.cols);
+	uint64_t rng[LANES];
+	seed_lanes(rng, 1);
+	bitgame_t* games = (bitgame_t*) malloc(sizeof(bitgame_t) * n);
+	int* margins = (int*) malloc(sizeof(int) * n);
+
+	opening_t openings[playout.n_walls];
+	int n_openings = 0;
+	double start = now_ms();
+	for(turn_t* t = board.sentinel->next; t != board.sentinel; t = t->next){
+		execute_turn(t, &board);
+		turn_t* memo = remove_turn_dll(t);
+		if(bitboard){
+			board_to_bitgame(&board, &layout, &games[0]);
+			for(long int i=1; i<n; ++i) games[i] = games[0];
+			bit_playouts(&layout, games, margins, n, rng);
+		} else{
+			for(long int i=0; i<n; ++i) margins[i] = random_playout(&playout, &board);
+		}
+		add_turn_dll(memo, t);
+		unexecute_turn(t, &board);
+
+		double sum = 0, wins = 0;
+		for(long int i=0; i<n; ++i){
+			sum += margins[i];
+			wins += margins[i] > 0 ? 1 : (margins[i] == 0 ? 0.5 : 0);
+		}
+		openings[n_openings].turn = t;
+		openings[n_openings].mean = sum / n;
+		openings[n_openings].win_rate = wins / n;
+		n_openings++;
+	}
+	double elapsed = now_ms() - start;
+
+	qsort(openings, n_openings, sizeof(opening_t), by_mean);
+	for(int k=0; k<n_openings; ++k){
+		turn_t* t = openings[k].turn;
+		printf("%d %d %s\tmean %+.3f\twin %.3f\n", t->row, t->col, wall_name(t->wall), openings[k].mean, openings[k].win_rate);
+	}
+	printf("%ld playouts in %.0f ms (%.0f/ms, %s)\n", n * n_openings, elapsed, n * n_openings / (elapsed > 0 ? elapsed : 1),
+		bitboard ? (LANES > 1 ? "simd" : "bitboard") : "scalar");
+
+	free(games);
+	free(margins);
+	free_playout(&playout);
+	cleanup(&board);
+
+	return 0;
+}
@@ -0,0 +1,111 @@
+#include "dotsnboxes_variants.h"
+
+/* move generation and make/unmake benchmark, apart from any search effects.
+	usage: solver_perft [-d depth] [variant [generic]], with a position on stdin (the text form of
+	       position_t, or just "rows cols" for the empty board)
+	       solver_perft -r [variant [generic]]
+	counts the leaves of the full game tree to every depth from 1 to 'depth' (default: as deep as
+	stays under about 10^8 leaves) with the variant's board functions, i.e. the generic ones or
+	the fixed-size kernel's, and how many turns a second that took. a game only ends once every
+	wall is drawn, so with w walls left there are exactly w!/(w-d)! leaves at depth d: any other
+	count is a bug in the turn list, reported as MISMATCH with exit status 1. that says nothing
+	about the scores or whose turn it is, so at each depth it also counts the boxes the turns
+	there complete, those of them that player 0 completes, and the turns after which the same
+	player moves again. -r checks all of them against reference counts for a few positions
+	(worked out apart from this code), which slips in make/unmake show up in. */
+
+#define PERFT_MAX 8
+
+typedef struct PerftReference{
+	const char* position;
+	int depth;
+	// at depths 1 to 'depth'
+	long int leaves[PERFT_MAX];
+	long int captures[PERFT_MAX];
+	long int player0_captures[PERFT_MAX];
+	long int extra_turns[PERFT_MAX];
+} perft_reference_t;
+
+perft_reference_t references[] = {
+	{"1 2 0 0 0 0", 7, {7, 42, 210, 840, 2520, 5040, 5040}, {0, 0, 0, 48, 576, 2880, 5760},
+		{0, 0, 0, 0, 576, 0, 1440}, {0, 0, 0, 48, 576, 2880, 5040}},
+	{"2 2 0 0 0 0", 5, {12, 132, 1320, 11880, 95040}, {0, 0, 0, 96, 3072}, {0, 0, 0, 0, 3072}, {0, 0, 0, 96, 3072}},
+	{"2 3 873b 1 0 1", 6, {8, 56, 336, 1680, 6720, 20160}, {2, 16, 120, 780, 4080, 15840},
+		{0, 14, 40, 352, 2340, 9060}, {2, 16, 118, 744, 3744, 13920}},
+	{"3 3 a7d666 1 0 1", 5, {10, 90, 720, 5040, 30240}, {2, 26, 284, 2604, 19824},
+		{0, 24, 92, 1190, 11238}, {2, 26, 278, 2460, 17880}},
+};
+
+/* the table for the board to 'depth', checked against 'reference' if there is one. how many
+	counts did not match */
+int perft_run(variant_t* variant, board_t* board, int depth, const perft_reference_t* reference){
+	int walls = n_walls(board) - __builtin_popcountll(board->uid);
+	printf("%s%s, %dx%d, %d walls left\n", variant->name, variant->rows ? " (fixed size)" : "", board->rows, board->cols, walls);
+	printf("%5s %16s %16s %14s %14s %14s %10s %10s\n", "depth", "leaves", "expected", "captures", "by player 0", "extra turns",
+		"ms", "Mnps");
+	int mismatches = 0;
+	double expected = 1, turns = 0;
+	for(int d=1; d<=depth; ++d){
+		expected *= walls - d + 1;
+		// every level above the leaves was walked on the way down
+		turns += expected;
+		perft_counts_t counts;
+		memset(&counts, 0, sizeof(counts));
+		double start = now_ms();
+		long int leaves = variant->perft(board, d, 1, &counts);
+		double ms = now_ms() - start;
+		bool ok = leaves == (long int) expected;
+		if(reference != NULL) ok = ok && leaves == reference->leaves[d-1] && counts.captures[d] == reference->captures[d-1]
+			&& counts.player0_captures[d] == reference->player0_captures[d-1] && counts.extra_turns[d] == reference->extra_turns[d-1];
+		mismatches += !ok;
+		printf("%5d %16ld %16.0f %14ld %14ld %14ld %10.1f %10.2f%s\n", d, leaves, expected, counts.captures[d],
+			counts.player0_captures[d], counts.extra_turns[d], ms, ms > 0 ? turns / ms / 1e3 : 0, ok ? "" : "  MISMATCH");
+	}
+	return mismatches;
+}
+
+int main(int argc, char** argv){
+	const char* name = "ab_sym_memo_order";
+	bool generic = false, check = false;
+	int depth = -1;
+	for(int a=1; a<argc; ++a){
+		if(strcmp(argv[a], "-d") == 0 && a+1 < argc) depth = atoi(argv[++a]);
+		else if(strcmp(argv[a], "-r") == 0) check = true;
+		else if(strcmp(argv[a], "generic") == 0) generic = true;
+		else if(argv[a][0] != '-' && find_variant(argv[a], 0, 0, true) != NULL) name = argv[a];
+		else{
+			fprintf(stderr, "usage: %s [-d depth] [variant [generic]]  (a position on stdin)\n"
+				"       %s -r [variant [generic]]\n", argv[0], argv[0]);
+			return 2;
+		}
+	}
+
+	int mismatches = 0;
+	board_t board;
+	if(check){
+		for(size_t r=0; r<sizeof(references)/sizeof(references[0]); ++r){
+			text_to_board(references[r].position, &board);
+			printf("%s%s: ", r ? "\n" : "", references[r].position);
+			mismatches += perft_run(find_variant(name, board.rows, board.cols, generic), &board, references[r].depth, &references[r]);
+			cleanup(&board);
+		}
+		return mismatches > 0 ? 1 : 0;
+	}
+
+	char line[256];
+	if(fgets(line, sizeof(line), stdin) == NULL || !text_to_board(line, &board)){
+		fprintf(stderr, "not a position\n");
+		return 2;
+	}
+	int walls = n_walls(&board) - __builtin_popcountll(board.uid);
+	if(depth < 0){
+		double leaves = 1;
+		for(depth = 0; depth < walls && leaves * (walls - depth) <= 1e8; ++depth) leaves *= walls - depth;
+	}
+	if(depth > walls) depth = walls;
+	// the counts go by ply
+	if(depth >= MAX_DEPTH) depth = MAX_DEPTH - 1;
+	mismatches = perft_run(find_variant(name, board.rows, board.cols, generic), &board, depth, NULL);
+	cleanup(&board);
+	return mismatches > 0 ? 1 : 0;
+}
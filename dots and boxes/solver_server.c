@@ -0,0 +1,235 @@
+#include "dotsnboxes_variants.h"
+#include "dotsnboxes_session.h"
+#include <signal.h>
+
+/* plays many games at once for clients on a unix stream socket, one session (dotsnboxes_session.h)
+	per connection, speaking the same line protocol as solver_session, e.g. with
+	"socat - UNIX-CONNECT:path".
+	usage: solver_server [-d file]... [-B file]... [-s ms] [-m ms] [-t turns] [-b bits] [-M mb] [variant [generic]] path
+		-d      a table of solved positions (solver_db), mapped read-only once and looked up by every
+		        session of its board size; other server processes mapping the same file share its
+		        pages too
+		-B      an opening book (solver_book), shared likewise and looked up first
+		-s      time slice in ms (default 20)
+		-m, -t  limits for each "go", as in solver_session; time is the session's own thinking,
+		        not the time spent waiting for a slice
+		-b      2^bits buckets in each session's own table (default 20)
+		-M      each session's table size in MB past which it drops old entries (default 64)
+
+	one thread does all the searching: sessions with a "go" to answer take turns, a slice each,
+	round robin, and commands and connections are dealt with between slices, so that a client
+	that asks for a deep solve slows the others down but never blocks them. a session's table only
+	holds what the shared tables do not, and starts small. there is no pondering. a client's
+	further commands wait until its "go" is answered. SIGINT or SIGTERM stops the server. */
+
+#define SERVER_DBS 8
+#define SERVER_LINE 256
+
+typedef struct Client{
+	int fd;
+	session_t session;
+	char in[SERVER_LINE]; // what has come in and not been carried out yet
+	int in_length;
+	bool overlong; // in the middle of a line too long to take, which is dropped
+	char* out; // what is still to be sent
+	size_t out_length, out_size;
+	bool closing; // once everything is sent
+} client_t;
+
+volatile sig_atomic_t server_stop = 0;
+
+void server_signal(int signal){
+	(void) signal;
+	server_stop = 1;
+}
+
+/* queue one line for the client */
+void client_send(client_t* c, const char* line){
+	size_t n = strlen(line) + 1;
+	if(c->out_length + n > c->out_size){
+		c->out_size = 2 * (c->out_length + n);
+		c->out = (char*) realloc(c->out, c->out_size);
+	}
+	memcpy(c->out + c->out_length, line, n - 1);
+	c->out[c->out_length + n - 1] = '\n';
+	c->out_length += n;
+}
+
+/* carry out the client's complete lines, up to the first "go" */
+void client_run(client_t* c){
+	char reply[SERVER_LINE];
+	while(!c->session.thinking && !c->closing){
+		char* end = memchr(c->in, '\n', c->in_length);
+		if(end == NULL) return;
+		*end = '\0';
+		if(end > c->in && end[-1] == '\r') end[-1] = '\0';
+		char command[16] = "";
+		sscanf(c->in, "%15s", command);
+		if(c->overlong){
+			c->overlong = false;
+			client_send(c, "error line too long");
+		} else if(strcmp(command, "ponder") == 0){
+			client_send(c, "error no pondering on the server");
+		} else{
+			int todo = session_command(&c->session, c->in, reply, sizeof(reply));
+			if(todo == SESSION_QUIT) c->closing = true;
+			else if(todo == SESSION_REPLY && reply[0] != '\0') client_send(c, reply);
+		}
+		int used = end + 1 - c->in;
+		memmove(c->in, end + 1, c->in_length - used);
+		c->in_length -= used;
+	}
+}
+
+/* take whatever the client sent. false once it hung up */
+bool client_read(client_t* c){
+	if(c->session.thinking && c->in_length == SERVER_LINE) return true;
+	if(c->in_length == SERVER_LINE){
+		// no end of line in a whole buffer: keep the first bytes for the command, drop the rest
+		c->overlong = true;
+		c->in_length = 16;
+	}
+	ssize_t n = recv(c->fd, c->in + c->in_length, SERVER_LINE - c->in_length, 0);
+	if(n <= 0) return n < 0 && (errno == EINTR || errno == EAGAIN);
+	c->in_length += n;
+	client_run(c);
+	return true;
+}
+
+/* send what can be sent without waiting. false once it cannot be sent at all */
+bool client_write(client_t* c){
+	ssize_t n = send(c->fd, c->out, c->out_length, MSG_NOSIGNAL | MSG_DONTWAIT);
+	if(n < 0) return errno == EINTR || errno == EAGAIN;
+	memmove(c->out, c->out + n, c->out_length - n);
+	c->out_length -= n;
+	return true;
+}
+
+void client_free(client_t* c){
+	close(c->fd);
+	session_free(&c->session);
+	free(c->out);
+	free(c);
+}
+
+int main(int argc, char** argv){
+	// what every session starts with
+	session_t defaults;
+	session_init(&defaults);
+	defaults.memo_bits = 20;
+	double budget_mb = 64, slice_ms = 20;
+	solved_db_t dbs[SERVER_DBS];
+	book_t books[SERVER_DBS];
+	const char* path = NULL;
+	for(int a=1; a<argc; ++a){
+		if(strcmp(argv[a], "-m") == 0 && a+1 < argc) defaults.move_ms = atof(argv[++a]);
+		else if(strcmp(argv[a], "-t") == 0 && a+1 < argc) defaults.move_turns = atol(argv[++a]);
+		else if(strcmp(argv[a], "-M") == 0 && a+1 < argc) budget_mb = atof(argv[++a]);
+		else if(strcmp(argv[a], "-b") == 0 && a+1 < argc) defaults.memo_bits = atoi(argv[++a]);
+		else if(strcmp(argv[a], "-s") == 0 && a+1 < argc) slice_ms = atof(argv[++a]);
+		else if(strcmp(argv[a], "-d") == 0 && a+1 < argc && defaults.n_dbs < SERVER_DBS){
+			const char* error = db_open(&dbs[defaults.n_dbs], argv[++a]);
+			if(error != NULL){
+				fprintf(stderr, "%s: %s\n", argv[a], error);
+				return 1;
+			}
+			defaults.n_dbs++;
+		}
+		else if(strcmp(argv[a], "-B") == 0 && a+1 < argc && defaults.n_books < SERVER_DBS){
+			const char* error = book_open(&books[defaults.n_books], argv[++a]);
+			if(error != NULL){
+				fprintf(stderr, "%s: %s\n", argv[a], error);
+				return 1;
+			}
+			defaults.n_books++;
+		}
+		else if(strcmp(argv[a], "generic") == 0) defaults.generic = true;
+		else if(argv[a][0] != '-' && find_variant(argv[a], 0, 0, true) != NULL) defaults.name = argv[a];
+		else if(argv[a][0] != '-' && path == NULL) path = argv[a];
+		else path = NULL, a = argc;
+	}
+	if(path == NULL || slice_ms <= 0 || defaults.memo_bits < 1 || defaults.memo_bits > 40){
+		fprintf(stderr, "usage: %s [-d file]... [-B file]... [-s ms] [-m ms] [-t turns] [-b bits] [-M mb] [variant [generic]] path\n", argv[0]);
+		return 2;
+	}
+	defaults.dbs = dbs;
+	defaults.books = books;
+	defaults.budget = (long int) (budget_mb * 1048576 / sizeof(memo_t));
+
+	int listen_fd = progress_listen(path);
+	if(listen_fd < 0){
+		fprintf(stderr, "cannot listen on %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = server_signal;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	client_t** clients = NULL;
+	struct pollfd* fds = NULL;
+	int n_clients = 0, size = 0, next = 0;
+	char reply[SERVER_LINE];
+	while(!server_stop){
+		// clients only wait for the socket while nobody is thinking
+		bool thinking = false;
+		fds = (struct pollfd*) realloc(fds, sizeof(struct pollfd) * (n_clients + 1));
+		fds[0] = (struct pollfd) {listen_fd, POLLIN, 0};
+		for(int i=0; i<n_clients; ++i){
+			client_t* c = clients[i];
+			thinking |= c->session.thinking;
+			// a full buffer behind a "go" waits for it
+			bool room = !c->closing && !(c->session.thinking && c->in_length == SERVER_LINE);
+			fds[i+1] = (struct pollfd) {c->fd, (room ? POLLIN : 0) | (c->out_length > 0 ? POLLOUT : 0), 0};
+		}
+		if(poll(fds, n_clients + 1, thinking ? 0 : -1) < 0 && errno != EINTR) break;
+		// one slice for the next session with a "go", round robin
+		if(thinking){
+			for(int k=0; k<n_clients; ++k){
+				client_t* c = clients[(next + k) % n_clients];
+				if(!c->session.thinking) continue;
+				if(session_think(&c->session, slice_ms, reply, sizeof(reply))){
+					client_send(c, reply);
+					client_run(c);
+				}
+				next = (next + k + 1) % n_clients;
+				break;
+			}
+		}
+		for(int i=n_clients-1; i>=0; --i){
+			client_t* c = clients[i];
+			bool alive = true;
+			if(fds[i+1].revents & (POLLIN | POLLHUP)) alive = client_read(c);
+			if(alive && (fds[i+1].revents & POLLERR)) alive = false;
+			if(alive && c->out_length > 0) alive = client_write(c);
+			if(alive && c->closing && c->out_length == 0) alive = false;
+			if(!alive){
+				client_free(c);
+				clients[i] = clients[--n_clients];
+			}
+		}
+		if(fds[0].revents & POLLIN){
+			int fd = accept(listen_fd, NULL, NULL);
+			if(fd >= 0){
+				if(n_clients == size){
+					size = size ? 2 * size : 16;
+					clients = (client_t**) realloc(clients, sizeof(client_t*) * size);
+				}
+				client_t* c = (client_t*) calloc(1, sizeof(client_t));
+				c->fd = fd;
+				c->session = defaults;
+				clients[n_clients++] = c;
+			}
+		}
+	}
+	for(int i=0; i<n_clients; ++i) client_free(clients[i]);
+	free(clients);
+	free(fds);
+	close(listen_fd);
+	unlink(path);
+	for(int d=0; d<defaults.n_dbs; ++d) db_close(&dbs[d]);
+	for(int b=0; b<defaults.n_books; ++b) book_close(&books[b]);
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include "dotsnboxes_variants.h"
+#include "dotsnboxes_session.h"
+
+/* plays whole games as a long-lived process, one command per line on stdin, each answered by one
+	line on stdout (see dotsnboxes_session.h for the commands).
+	usage: solver_session [-m ms] [-t turns] [-M mb] [-b bits] [-d file]... [-B file]... [-n] [variant [generic]]
+		-m, -t  limits for each "go" (default none: every answer is exact)
+		-M      table size in MB past which entries not used by the last two searches are dropped
+		        (default 2048)
+		-b      2^bits buckets in the table (default HASHTABLE_BITWIDTH)
+		-d      a table of solved positions (solver_db) to look up under the session's own, one
+		        per board size
+		-B      an opening book (solver_book) to look up first, one per board size
+		-n      no pondering */
+
+#define SESSION_DBS 8
+
+int main(int argc, char** argv){
+	session_t s;
+	session_init(&s);
+	s.ponder = true;
+	double budget_mb = 2048;
+	solved_db_t dbs[SESSION_DBS];
+	book_t books[SESSION_DBS];
+	for(int a=1; a<argc; ++a){
+		if(strcmp(argv[a], "-m") == 0 && a+1 < argc) s.move_ms = atof(argv[++a]);
+		else if(strcmp(argv[a], "-t") == 0 && a+1 < argc) s.move_turns = atol(argv[++a]);
+		else if(strcmp(argv[a], "-M") == 0 && a+1 < argc) budget_mb = atof(argv[++a]);
+		else if(strcmp(argv[a], "-b") == 0 && a+1 < argc) s.memo_bits = atoi(argv[++a]);
+		else if(strcmp(argv[a], "-d") == 0 && a+1 < argc && s.n_dbs < SESSION_DBS){
+			const char* error = db_open(&dbs[s.n_dbs], argv[++a]);
+			if(error != NULL){
+				fprintf(stderr, "%s: %s\n", argv[a], error);
+				return 1;
+			}
+			s.n_dbs++;
+		}
+		else if(strcmp(argv[a], "-B") == 0 && a+1 < argc && s.n_books < SESSION_DBS){
+			const char* error = book_open(&books[s.n_books], argv[++a]);
+			if(error != NULL){
+				fprintf(stderr, "%s: %s\n", argv[a], error);
+				return 1;
+			}
+			s.n_books++;
+		}
+		else if(strcmp(argv[a], "-n") == 0) s.ponder = false;
+		else if(strcmp(argv[a], "generic") == 0) s.generic = true;
+		else if(argv[a][0] != '-' && find_variant(argv[a], 0, 0, true) != NULL) s.name = argv[a];
+		else{
+			fprintf(stderr, "usage: %s [-m ms] [-t turns] [-M mb] [-b bits] [-d file]... [-B file]... [-n] [variant [generic]]\n", argv[0]);
+			return 2;
+		}
+	}
+	if(s.memo_bits < 0 || s.memo_bits > 40){
+		fprintf(stderr, "-b: between 1 and 40\n");
+		return 2;
+	}
+	s.dbs = dbs;
+	s.books = books;
+	s.budget = (long int) (budget_mb * 1048576 / sizeof(memo_t));
+
+	char line[256], reply[256];
+	while(fgets(line, sizeof(line), stdin) != NULL){
+		line[strcspn(line, "\r\n")] = '\0';
+		int todo = session_command(&s, line, reply, sizeof(reply));
+		if(todo == SESSION_QUIT) break;
+		if(todo == SESSION_GO) session_think(&s, 0, reply, sizeof(reply));
+		if(reply[0] != '\0') printf("%s\n", reply);
+		fflush(stdout);
+	}
+	session_free(&s);
+	for(int d=0; d<s.n_dbs; ++d) db_close(&dbs[d]);
+	for(int b=0; b<s.n_books; ++b) book_close(&books[b]);
+	return 0;
+}
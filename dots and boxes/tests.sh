@@ -1,83 +1,195 @@
 #!/bin/sh
+# quick eyeball run of every binary. for numbers to compare, use "make bench" (solver_bench.c)
 
 echo "== BRUTE FORCE =="
 echo "\ntest 1x1"
-time echo "1 1" | ./solver_brute
+time echo "1 1" | ./solver brute
 echo "\ntest 1x2"
-time echo "1 2" | ./solver_brute
+time echo "1 2" | ./solver brute
 echo "\ntest 2x2"
-time echo "2 2" | ./solver_brute
-#time echo "2 3" | ./solver_brute
+time echo "2 2" | ./solver brute
+#time echo "2 3" | ./solver brute
 
 echo "\n\n== ALPHA BETA =="
 echo "\ntest 1x1"
-time echo "1 1" | ./solver_ab
+time echo "1 1" | ./solver ab
 echo "\ntest 1x2"
-time echo "1 2" | ./solver_ab
+time echo "1 2" | ./solver ab
 echo "\ntest 2x2"
-time echo "2 2" | ./solver_ab
+time echo "2 2" | ./solver ab
 echo "\ntest 2x3"
-time echo "2 3" | ./solver_ab
+time echo "2 3" | ./solver ab
 
 echo "\n\n== SIMPLE SYMMETRIES =="
 echo "\ntest 1x1"
-time echo "1 1" | ./solver_brute_sym
+time echo "1 1" | ./solver brute_sym
 echo "\ntest 1x2"
-time echo "1 2" | ./solver_brute_sym
+time echo "1 2" | ./solver brute_sym
 echo "\ntest 2x2"
-time echo "2 2" | ./solver_brute_sym
-#time echo "2 3" | ./solver_brute_sym
+time echo "2 2" | ./solver brute_sym
+#time echo "2 3" | ./solver brute_sym
 
 echo "\n\n== ALPHA BETA + SYMMETRIES =="
 echo "\ntest 1x1"
-time echo "1 1" | ./solver_ab_sym
+time echo "1 1" | ./solver ab_sym
 echo "\ntest 1x2"
-time echo "1 2" | ./solver_ab_sym
+time echo "1 2" | ./solver ab_sym
 echo "\ntest 2x2"
-time echo "2 2" | ./solver_ab_sym
+time echo "2 2" | ./solver ab_sym
 echo "\ntest 2x3"
-time echo "2 3" | ./solver_ab_sym
+time echo "2 3" | ./solver ab_sym
 
 echo "\n\n== BRUTE FORCE + MEMOIZATION =="
 echo "\ntest 1x1"
-time echo "1 1" | ./solver_brute_memo
+time echo "1 1" | ./solver brute_memo
 echo "\ntest 1x2"
-time echo "1 2" | ./solver_brute_memo
+time echo "1 2" | ./solver brute_memo
 echo "\ntest 2x2"
-time echo "2 2" | ./solver_brute_memo
+time echo "2 2" | ./solver brute_memo
 echo "\ntest 2x3"
-time echo "2 3" | ./solver_brute_memo
+time echo "2 3" | ./solver brute_memo
 
 echo "\n\n== ALPHA BETA + MEMOIZATION =="
 echo "\ntest 1x1"
-time echo "1 1" | ./solver_ab_memo
+time echo "1 1" | ./solver ab_memo
 echo "\ntest 1x2"
-time echo "1 2" | ./solver_ab_memo
+time echo "1 2" | ./solver ab_memo
 echo "\ntest 2x2"
-time echo "2 2" | ./solver_ab_memo
+time echo "2 2" | ./solver ab_memo
 echo "\ntest 2x3"
-time echo "2 3" | ./solver_ab_memo
+time echo "2 3" | ./solver ab_memo
 echo "\ntest 3x3"
-time echo "3 3" | ./solver_ab_memo
+time echo "3 3" | ./solver ab_memo
 
 echo "\n\n== SIMPLE SYMMETRIES + MEMOIZATION =="
 echo "\ntest 1x1"
-time echo "1 1" | ./solver_brute_sym_memo
+time echo "1 1" | ./solver sym_memo
 echo "\ntest 1x2"
-time echo "1 2" | ./solver_brute_sym_memo
+time echo "1 2" | ./solver sym_memo
 echo "\ntest 2x2"
-time echo "2 2" | ./solver_brute_sym_memo
+time echo "2 2" | ./solver sym_memo
 echo "\ntest 2x3"
-time echo "2 3" | ./solver_brute_sym_memo
+time echo "2 3" | ./solver sym_memo
 
 echo "\n\n== ALPHA BETA + SYMMETRIES + MEMOIZATION =="
 echo "\ntest 1x1"
-time echo "1 1" | ./solver_ab_sym_memo
+time echo "1 1" | ./solver ab_sym_memo
 echo "\ntest 1x2"
-time echo "1 2" | ./solver_ab_sym_memo
+time echo "1 2" | ./solver ab_sym_memo
 echo "\ntest 2x2"
-time echo "2 2" | ./solver_ab_sym_memo
+time echo "2 2" | ./solver ab_sym_memo
 echo "\ntest 2x3"
-time echo "2 3" | ./solver_ab_sym_memo
+time echo "2 3" | ./solver ab_sym_memo
 echo "\ntest 3x3"
-time echo "3 3" | ./solver_ab_sym_memo
+time echo "3 3" | ./solver ab_sym_memo
+
+echo "\n\n== ALPHA BETA + SYMMETRIES + MEMOIZATION + MOVE ORDERING =="
+echo "\ntest 2x2"
+time echo "2 2" | ./solver ab_sym_memo_order
+echo "\ntest 2x3"
+time echo "2 3" | ./solver ab_sym_memo_order
+echo "\ntest 3x3"
+time echo "3 3" | ./solver ab_sym_memo_order
+echo "\ntest 3x3 (generic kernel)"
+time echo "3 3" | ./solver ab_sym_memo_order generic
+echo "\ntest 3x3 (every first turn, compare with the turns of one solve)"
+time echo "3 3" | ./solver ab_sym_memo_order all
+
+echo "\n\n== MONTE CARLO TREE SEARCH (1s per move, first 2 moves) =="
+echo "\ntest 5x5"
+time echo "5 5 1000 256 2" | ./solver_mcts
+echo "\ntest 6x6"
+time echo "6 6 1000 256 2" | ./solver_mcts
+echo "\ntest 9x9"
+time echo "9 9 1000 256 2" | ./solver_mcts
+
+echo "\n\n== OPENING PLAYOUT STATISTICS (build with 'make native' for SIMD) =="
+echo "\ntest 3x3"
+time echo "3 3 100000" | ./solver_openings
+echo "\ntest 5x5"
+time echo "5 5 100000" | ./solver_openings
+
+echo "\n\n== PROOF-NUMBER SEARCH (win/draw/lose only) =="
+echo "\ntest 1x1"
+time echo "1 1" | ./solver_pns
+echo "\ntest 1x2"
+time echo "1 2" | ./solver_pns
+echo "\ntest 2x2"
+time echo "2 2" | ./solver_pns
+echo "\ntest 2x3"
+time echo "2 3" | ./solver_pns
+echo "\ntest 2x4"
+time echo "2 4" | ./solver_pns
+echo "\ntest 3x3"
+time echo "3 3" | ./solver_pns
+echo "\ntest a 5x5 position with player 0 ten boxes up (against the exact value below)"
+time echo "5 5 3fcf033cb5a56e7 10 0 0" | ./solver_pns
+time echo "5 5 3fcf033cb5a56e7 10 0 0" | ./solver_batch
+
+echo "\n\n== TREE SIZE ESTIMATE (compare with the 3x3 solves above) =="
+echo "\ntest 3x3"
+time echo "3 3" | ./solver_estimate
+echo "\ntest 2x4"
+time echo "2 4" | ./solver_estimate
+echo "\ntest 2x3 (split 0: the real solve)"
+time echo "2 3" | ./solver_estimate
+echo "\ntest 2x3 (alpha beta + symmetries)"
+time echo "2 3" | ./solver_estimate -d 6 ab_sym
+
+echo "\n\n== PERFT (move generation and make/unmake only) =="
+echo "\ntest 3x3"
+time echo "3 3" | ./solver_perft
+echo "\ntest 3x3 (generic board functions)"
+time echo "3 3" | ./solver_perft ab_sym_memo_order generic
+echo "\ntest 4x4"
+time echo "4 4" | ./solver_perft
+echo "\ntest reference counts (captures, by player, extra turns)"
+time ./solver_perft -r
+echo "\ntest reference counts (generic board functions)"
+time ./solver_perft -r ab_sym_memo_order generic
+echo "\ntest a mid-game 3x3 position"
+time echo "3 3 a7d666 1 0 1" | ./solver_perft
+
+echo "\n\n== BATCH (mid-game positions, one warm table) =="
+echo "\ntest 2x3 positions (values and best turns)"
+time printf "2 3\n2 3 1a1 0 0 0\n2 3 1ff 0 0 1\n1 1 d 0 0 1\n" | ./solver_batch
+echo "\ntest 2x2 (every turn)"
+time echo "2 2 3 0 0 0" | ./solver_batch -a
+echo "\ntest 2x3 positions on 4 threads (same values, same order)"
+time printf "2 3\n2 3 1a1 0 0 0\n2 3 1ff 0 0 1\n1 1 d 0 0 1\n" | ./solver_batch -j 4
+
+echo "\n\n== SESSION (one process for a whole game, pondering between moves) =="
+echo "\ntest 3x3 (the second go is a table lookup)"
+time printf "new 3 3\ngo\nmove 0 0 left\ngo\nshow\nquit\n" | ./solver_session
+
+echo "\n\n== SOLVED TABLES AND SERVER (one read-only table under every session) =="
+echo "\ntest 2x3 table, then a session on top of it (the first go is a lookup)"
+time echo "2 3" | ./solver_db /tmp/dnb_2x3.db
+time printf "new 2 3\ngo\nmove 0 0 left\ngo\nquit\n" | ./solver_session -n -d /tmp/dnb_2x3.db
+echo "\ntest 3 clients of one server, in time slices"
+./solver_server -d /tmp/dnb_2x3.db -s 5 /tmp/dnb_server.sock &
+sleep 1
+time python3 -c '
+import socket
+clients = [socket.socket(socket.AF_UNIX) for i in range(3)]
+for c in clients: c.connect("/tmp/dnb_server.sock")
+for i, c in enumerate(clients): c.sendall(["new 2 3\ngo\nquit\n", "new 2 3\nmove 0 0 top\ngo\nquit\n", "position 2 3 1a1 0 0 0\ngo\nquit\n"][i].encode())
+for c in clients: print(c.makefile().read(), end="")
+'
+kill $!
+
+echo "\n\n== OPENING BOOK (the first turns solved once, offline) =="
+echo "\ntest 2x3 book to 4 plies"
+time echo "2 3" | ./solver_book -p 4 /tmp/dnb_2x3.book
+echo "\ntest 2x3 from the book (no turns searched)"
+time echo "2 3" | DNB_BOOK=/tmp/dnb_2x3.book ./solver ab_sym_memo_order all
+echo "\ntest 2x3 positions through the book, every turn (values as without it)"
+time printf "2 3\n2 3 1a1 0 0 0\n2 3 3 0 0 1\n" | ./solver_batch -a -B /tmp/dnb_2x3.book
+
+echo "\n\n== DISTRIBUTED (a coordinator and two workers through a directory queue) =="
+echo "\ntest 3x3 split 2 plies down"
+rm -rf /tmp/dnb_dist
+./solver_dist work /tmp/dnb_dist 2> /dev/null &
+./solver_dist work /tmp/dnb_dist 2> /dev/null &
+time echo "3 3" | ./solver_dist -p 2 coordinate /tmp/dnb_dist 2> /dev/null
+wait
@@ -0,0 +1,107 @@
+#include "dotsnboxes.h"
+#include "dotsnboxes_trace.h"
+
+/* prints a trace dumped by a debug build of solver (see dotsnboxes_trace.h) as an indented tree.
+	usage: trace_decode file [max_depth] */
+
+const char* bound_name(int bound){
+	return bound == BOUND_LOWER ? ">=" : (bound == BOUND_UPPER ? "<=" : "=");
+}
+
+void print_turn(board_t* board, int index){
+	if(index == TRACE_NONE || index >= n_walls(board)){
+		printf("-");
+		return;
+	}
+	turn_t* t = board->turns[index];
+	printf("%d %d %s", t->row, t->col, wall_name(t->wall));
+}
+
+int main(int argc, char** argv){
+	if(argc < 2){
+		fprintf(stderr, "usage: %s file [max_depth]\n", argv[0]);
+		return 2;
+	}
+	int max_depth = argc > 2 ? atoi(argv[2]) : INT_MAX;
+	FILE* f = fopen(argv[1], "rb");
+	if(f == NULL){
+		fprintf(stderr, "cannot read %s\n", argv[1]);
+		return 1;
+	}
+	trace_header_t h;
+	if(fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, TRACE_MAGIC, sizeof(h.magic)) != 0 || h.version != TRACE_VERSION){
+		fprintf(stderr, "%s is not a version %d trace\n", argv[1], TRACE_VERSION);
+		fclose(f);
+		return 1;
+	}
+	board_t board;
+	init_board(&board, h.rows, h.cols);
+	printf("%ux%u, %llu records", h.rows, h.cols, (unsigned long long) h.written);
+	if(h.written > h.capacity) printf(" (the oldest %llu were overwritten)", (unsigned long long) (h.written - h.capacity));
+	if(h.sample > 1) printf(", one in %u subtrees at depth %u", h.sample, h.sample_depth);
+	printf("\n");
+
+	// the window each open node was entered with, to tell exact values from bounds. once the ring
+	// has wrapped, the nodes that were open at its start have lost theirs
+	int window[256][2] = {{0}};
+	bool known[256] = {false};
+	trace_record_t r;
+	while(fread(&r, sizeof(r), 1, f) == 1){
+		if(r.kind >= N_TRACE_KINDS){
+			fprintf(stderr, "bad record kind %d\n", r.kind);
+			break;
+		}
+		if(r.depth > max_depth) continue;
+		for(int i=0; i<r.depth; ++i) printf(" ");
+		switch(r.kind){
+		case TRACE_NODE:
+			window[r.depth][0] = r.alpha;
+			window[r.depth][1] = r.beta;
+			known[r.depth] = true;
+			printf("node %016llx player %d (%d, %d)\n", (unsigned long long) r.uid, r.player, r.alpha, r.beta);
+			break;
+		case TRACE_MOVE:
+			print_turn(&board, r.index);
+			printf(" : %d\n", r.value);
+			break;
+		case TRACE_MEMO:
+			printf("memo: %s%d, best ", bound_name(r.bound), r.value);
+			print_turn(&board, r.index);
+			printf("\n");
+			break;
+		case TRACE_ETC:
+			printf("etc: ");
+			print_turn(&board, r.index);
+			printf(" -> %s%d\n", bound_name(r.bound), r.value);
+			break;
+		case TRACE_SYM:
+			printf("~(");
+			print_turn(&board, r.index);
+			printf(")~ <=%d=> ", r.value);
+			if(r.index < n_walls(&board) && board.turns[r.index]->pairs[r.value] != NULL)
+				print_turn(&board, board.turns[r.index]->pairs[r.value]->index);
+			printf("\n");
+			break;
+		case TRACE_CUTOFF:
+			printf("cutoff: ");
+			print_turn(&board, r.index);
+			printf(" %d (%d, %d)\n", r.value, r.alpha, r.beta);
+			break;
+		case TRACE_RETURN:
+			// the bound is from the maximizer's side, like the value; without the window, just the value
+			if(!known[r.depth]) printf("= %d, best ", r.value);
+			else printf("= %s%d, best ", bound_name(r.value <= window[r.depth][0] ? BOUND_UPPER :
+				(r.value >= window[r.depth][1] ? BOUND_LOWER : BOUND_EXACT)), r.value);
+			known[r.depth] = false;
+			print_turn(&board, r.index);
+			printf("\n");
+			break;
+		case TRACE_WINDOW:
+			printf("aspiration window (%d, %d)\n", r.alpha, r.beta);
+			break;
+		}
+	}
+	fclose(f);
+	cleanup(&board);
+	return 0;
+}